@@ -0,0 +1,154 @@
+#include <chrono>
+#include <cmath>
+
+#include <Eigen/Core>
+
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/trajectory/Func.h>
+
+using namespace BWC;
+
+namespace
+{
+//! Number of evaluations per measurement
+constexpr int evalNum = 10000000;
+
+//! Time step between evaluations [sec]
+constexpr double evalDt = 1e-7;
+
+/** \brief Evaluate polynomial derivative with the power series as a reference.
+    \param coeff coefficients of polynomial (from low order to high order)
+    \param dt arugment of function minus offset
+    \param derivativeOrder derivative order
+*/
+template<class T, int Order>
+T evalDerivativeNaive(const std::array<T, Order + 1> & coeff, double dt, int derivativeOrder)
+{
+  T ret = coeff[0] * 0.0;
+  for(int i = derivativeOrder; i <= Order; i++)
+  {
+    double factor = 1.0;
+    for(int j = 0; j < derivativeOrder; j++)
+    {
+      factor *= i - j;
+    }
+    ret += factor * std::pow(dt, i - derivativeOrder) * coeff[i];
+  }
+  return ret;
+}
+
+/** \brief Norm of value. */
+inline double norm(double value)
+{
+  return std::abs(value);
+}
+
+/** \brief Norm of value. */
+inline double norm(const Eigen::Vector3d & value)
+{
+  return value.norm();
+}
+
+/** \brief Measure the computation duration per evaluation.
+    \param evalFunc function to evaluate at the specified time
+    \param sink sum of the results, which prevents the evaluations from being optimized out
+    \returns computation duration per evaluation [ns]
+*/
+template<class T, class EvalFunc>
+double measure(const EvalFunc & evalFunc, T & sink)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  for(int i = 0; i < evalNum; i++)
+  {
+    sink += evalFunc(evalDt * i);
+  }
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count() / evalNum;
+}
+
+/** \brief Benchmark cubic polynomial.
+    \param name name of value type
+    \param coeff coefficients of polynomial
+    \returns whether the results match the reference
+*/
+template<class T>
+bool benchmarkCubicPolynomial(const std::string & name, const std::array<T, 4> & coeff)
+{
+  constexpr double t0 = 0.2;
+  constexpr double tolerance = 1e-9;
+
+  CubicPolynomial<T> poly(coeff, t0);
+  // Evaluate via the base class in the same way as the controller
+  const Func<T> & func = poly;
+
+  bool match = true;
+  T sink = coeff[0] * 0.0;
+  for(int derivativeOrder = 0; derivativeOrder <= 3; derivativeOrder++)
+  {
+    // Check that the results match the reference
+    double maxError = 0;
+    for(int i = 0; i < 1000; i++)
+    {
+      double t = t0 + 1e-3 * i;
+      T value = (derivativeOrder == 0 ? func(t) : func.derivative(t, derivativeOrder));
+      T refValue = evalDerivativeNaive<T, 3>(coeff, t - t0, derivativeOrder);
+      maxError = std::max(maxError, norm(value - refValue) / std::max(1.0, norm(refValue)));
+    }
+    if(maxError > tolerance)
+    {
+      mc_rtc::log::error("[FuncBenchmark] CubicPolynomial<{}> derivative order {} does not match the reference: {}",
+                         name, derivativeOrder, maxError);
+      match = false;
+    }
+
+    double duration;
+    if(derivativeOrder == 0)
+    {
+      duration = measure([&](double t) { return func(t); }, sink);
+    }
+    else
+    {
+      duration = measure([&](double t) { return func.derivative(t, derivativeOrder); }, sink);
+    }
+    double refDuration =
+        measure([&](double t) { return evalDerivativeNaive<T, 3>(coeff, t - t0, derivativeOrder); }, sink);
+    mc_rtc::log::info("[FuncBenchmark] CubicPolynomial<{}> derivative order {}: {:.2f} ns (power series {:.2f} ns)",
+                      name, derivativeOrder, duration, refDuration);
+  }
+
+  double evalAllDuration = measure(
+      [&](double t) -> T {
+        ValueWithDerivatives<T> valueWithDerivatives = func.evalAll(t, 2);
+        return valueWithDerivatives.value + valueWithDerivatives.vel + valueWithDerivatives.accel;
+      },
+      sink);
+  mc_rtc::log::info("[FuncBenchmark] CubicPolynomial<{}> evalAll up to order 2: {:.2f} ns", name, evalAllDuration);
+
+  mc_rtc::log::info("[FuncBenchmark] CubicPolynomial<{}> sum of results: {}", name, norm(sink));
+
+  return match;
+}
+} // namespace
+
+/** \brief Micro-benchmark of polynomial evaluation.
+
+    The value and derivatives of cubic polynomials are evaluated via the Func interface, and compared with the power
+    series evaluated with std::pow in both the results and the computation durations.
+*/
+int main()
+{
+  bool match = true;
+  match &= benchmarkCubicPolynomial<Eigen::Vector3d>(
+      "Eigen::Vector3d",
+      {Eigen::Vector3d(1.0, 2.0, 3.0), Eigen::Vector3d(-1.0, 0.5, 3.0), Eigen::Vector3d(2.0, -2.0, 0.1),
+       Eigen::Vector3d(4.0, 2.0, -3.0)});
+  match &= benchmarkCubicPolynomial<double>("double", {1.0, -2.0, 3.0, 4.0});
+
+  if(!match)
+  {
+    mc_rtc::log::error("[FuncBenchmark] Results do not match the reference.");
+    return 1;
+  }
+  mc_rtc::log::success("[FuncBenchmark] Results match the reference.");
+  return 0;
+}
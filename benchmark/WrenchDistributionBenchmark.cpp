@@ -0,0 +1,164 @@
+#include <random>
+
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/wrench/Contact.h>
+#include <BaselineWalkingController/wrench/WrenchDistribution.h>
+
+using namespace BWC;
+
+namespace
+{
+/** \brief Statistics of the computation duration. */
+struct DurationStat
+{
+  //! Sum of computation duration [ms]
+  double sum = 0;
+
+  //! Maximum computation duration [ms]
+  double max = 0;
+
+  //! Number of samples
+  int num = 0;
+
+  /** \brief Add a sample.
+      \param duration computation duration [ms]
+  */
+  void add(double duration)
+  {
+    sum += duration;
+    max = std::max(max, duration);
+    num++;
+  }
+
+  /** \brief Mean computation duration [ms]. */
+  double mean() const
+  {
+    return num > 0 ? sum / num : 0.0;
+  }
+};
+
+/** \brief Make a foot contact at a random pose around the nominal pose.
+    \param foot foot
+    \param rng random number generator
+*/
+std::shared_ptr<Contact> makeRandomContact(Foot foot, std::mt19937 & rng)
+{
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+
+  const std::vector<Eigen::Vector3d> localVertexList = {Eigen::Vector3d(-0.1, -0.05, 0), Eigen::Vector3d(-0.1, 0.05, 0),
+                                                        Eigen::Vector3d(0.1, 0.05, 0), Eigen::Vector3d(0.1, -0.05, 0)};
+  Eigen::Vector3d pos(0.2 * dist(rng), (foot == Foot::Left ? 0.1 : -0.1) + 0.05 * dist(rng), 0.05 * dist(rng));
+  Eigen::Matrix3d rot = (Eigen::AngleAxisd(0.5 * dist(rng), Eigen::Vector3d::UnitZ())
+                         * Eigen::AngleAxisd(0.2 * dist(rng), Eigen::Vector3d::UnitY())
+                         * Eigen::AngleAxisd(0.2 * dist(rng), Eigen::Vector3d::UnitX()))
+                            .toRotationMatrix();
+  return std::make_shared<Contact>(std::to_string(foot), 0.5, localVertexList, sva::PTransformd(rot, pos));
+}
+} // namespace
+
+/** \brief Benchmark of the solver modes of wrench distribution.
+
+    Wrench distribution is solved with the "Qp" and "ActiveSet" solver modes for random contact sets and desired
+    wrenches. The computation durations of both modes are reported, and the resulting total wrenches are checked to
+    match, since the weighted least squares problem has a unique optimal total wrench. Warm start is disabled so that
+    each case is solved from scratch.
+*/
+int main()
+{
+  constexpr int caseNum = 3000;
+  constexpr double wrenchTolerance = 1e-3; // Relative to the norm of the desired wrench
+
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<double> ratioDist(3.0, 60.0);
+  std::normal_distribution<double> noiseDist(0.0, 1.0);
+
+  mc_rtc::Configuration qpConfig;
+  qpConfig.add("enableWarmStart", false);
+  qpConfig.add("solverMode", "Qp");
+  mc_rtc::Configuration activeSetConfig;
+  activeSetConfig.add("enableWarmStart", false);
+  activeSetConfig.add("solverMode", "ActiveSet");
+
+  // Index 0 is single support and index 1 is double support
+  std::array<DurationStat, 2> qpDurationStats;
+  std::array<DurationStat, 2> activeSetDurationStats;
+  std::array<DurationStat, 2> activeSetIterStats;
+  double maxWrenchError = 0;
+  int mismatchNum = 0;
+
+  for(int caseIdx = 0; caseIdx < caseNum; caseIdx++)
+  {
+    // Set random contacts
+    FootMap<std::shared_ptr<Contact>> contactList;
+    if(caseIdx % 3 == 0)
+    {
+      contactList.emplace(Foot::Left, makeRandomContact(Foot::Left, rng));
+    }
+    else if(caseIdx % 3 == 1)
+    {
+      contactList.emplace(Foot::Right, makeRandomContact(Foot::Right, rng));
+    }
+    else
+    {
+      contactList.emplace(Foot::Left, makeRandomContact(Foot::Left, rng));
+      contactList.emplace(Foot::Right, makeRandomContact(Foot::Right, rng));
+    }
+    size_t statIdx = (contactList.size() == 1 ? 0 : 1);
+
+    // Set the desired wrench by perturbing a feasible wrench so that both feasible and infeasible cases are included
+    Eigen::Vector3d momentOrigin(0.05 * noiseDist(rng), 0.05 * noiseDist(rng), 0.8);
+    sva::ForceVecd desiredWrench = sva::ForceVecd::Zero();
+    for(const auto & contactKV : contactList)
+    {
+      Eigen::VectorXd wrenchRatio(contactKV.second->graspMat_.cols());
+      for(int i = 0; i < wrenchRatio.size(); i++)
+      {
+        wrenchRatio(i) = ratioDist(rng);
+      }
+      desiredWrench += contactKV.second->calcWrench(wrenchRatio, momentOrigin);
+    }
+    desiredWrench.moment() += 10.0 * Eigen::Vector3d(noiseDist(rng), noiseDist(rng), noiseDist(rng));
+    desiredWrench.force() += 20.0 * Eigen::Vector3d(noiseDist(rng), noiseDist(rng), noiseDist(rng));
+
+    // Solve with both solver modes
+    WrenchDistribution qpWrenchDist(contactList, qpConfig);
+    WrenchDistribution activeSetWrenchDist(contactList, activeSetConfig);
+    sva::ForceVecd qpWrench = qpWrenchDist.run(desiredWrench, momentOrigin);
+    sva::ForceVecd activeSetWrench = activeSetWrenchDist.run(desiredWrench, momentOrigin);
+    qpDurationStats[statIdx].add(qpWrenchDist.solveStat().duration);
+    activeSetDurationStats[statIdx].add(activeSetWrenchDist.solveStat().duration);
+    activeSetIterStats[statIdx].add(activeSetWrenchDist.solveStat().iterNum);
+
+    // Check that the total wrenches match
+    double wrenchError = (qpWrench.vector() - activeSetWrench.vector()).norm() / desiredWrench.vector().norm();
+    maxWrenchError = std::max(maxWrenchError, wrenchError);
+    if(wrenchError > wrenchTolerance)
+    {
+      mismatchNum++;
+      mc_rtc::log::warning("[WrenchDistributionBenchmark] Total wrenches do not match in case {}: relative error {}",
+                           caseIdx, wrenchError);
+    }
+  }
+
+  const std::array<std::string, 2> statNames = {"single support", "double support"};
+  for(size_t statIdx = 0; statIdx < statNames.size(); statIdx++)
+  {
+    mc_rtc::log::info("[WrenchDistributionBenchmark] {} ({} cases):", statNames[statIdx], qpDurationStats[statIdx].num);
+    mc_rtc::log::info("  Qp: mean {:.4f} ms, max {:.4f} ms", qpDurationStats[statIdx].mean(),
+                      qpDurationStats[statIdx].max);
+    mc_rtc::log::info("  ActiveSet: mean {:.4f} ms, max {:.4f} ms, mean iteration {:.1f}, max iteration {}",
+                      activeSetDurationStats[statIdx].mean(), activeSetDurationStats[statIdx].max,
+                      activeSetIterStats[statIdx].mean(), activeSetIterStats[statIdx].max);
+  }
+  mc_rtc::log::info("[WrenchDistributionBenchmark] Maximum relative error of total wrench: {}", maxWrenchError);
+
+  if(mismatchNum > 0)
+  {
+    mc_rtc::log::error("[WrenchDistributionBenchmark] Total wrenches do not match in {} / {} cases.", mismatchNum,
+                       caseNum);
+    return 1;
+  }
+  mc_rtc::log::success("[WrenchDistributionBenchmark] Total wrenches match in all {} cases.", caseNum);
+  return 0;
+}
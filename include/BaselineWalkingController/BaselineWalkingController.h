@@ -70,7 +70,7 @@ public:
   std::shared_ptr<mc_tasks::OrientationTask> baseOriTask_;
 
   //! Foot tasks
-  std::unordered_map<Foot, std::shared_ptr<FirstOrderImpedanceTask>> footTasks_;
+  FootMap<std::shared_ptr<FirstOrderImpedanceTask>> footTasks_;
 
   //! Foot manager
   std::shared_ptr<FootManager> footManager_;
@@ -1,5 +1,12 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <mc_rtc/gui/StateBuilder.h>
 #include <mc_rtc/log/Logger.h>
 
@@ -36,6 +43,34 @@ public:
     //! Whether to use actual state for MPC
     bool useActualStateForMpc = false;
 
+    //! Whether to run MPC asynchronously in a separate thread
+    bool enableAsyncMpc = false;
+
+    /** \brief Period of MPC in asynchronous mode [sec]
+
+        MPC is started from the state predicted at this period ahead, and its result is applied after this period.
+    */
+    double asyncMpcPeriod = 0.01;
+
+    /** \brief Method used while MPC overruns the deadline (empty for no fallback)
+
+        The fallback manager is configured by the same configuration overwritten by the "fallbackConfig" entry. The
+        fallback cannot be used with enableAsyncMpc. The fallback MPC is not run in the background while it is not used,
+        and it is warm started only with the ZMP and force Z planned in the last control cycle when switched to. The
+        original method is retried after fallbackDuration regardless of the computation headroom, and it is switched
+        back to the fallback method if it overruns the deadline in the first cycle.
+    */
+    std::string fallbackMethod = "";
+
+    //! Deadline of MPC computation per control cycle [ms]
+    double mpcDeadline = 1.0;
+
+    //! Number of consecutive overruns of the deadline to switch to the fallback method
+    int fallbackOverrunNum = 3;
+
+    //! Duration to use the fallback method before retrying the original method [sec]
+    double fallbackDuration = 1.0;
+
     //! Whether to enable DCM feedback
     bool enableZmpFeedback = true;
 
@@ -80,6 +115,13 @@ public:
    */
   CentroidalManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Destructor.
+
+      Inherited classes must call stopMpcThread() in their destructors, because their members are destroyed before this
+      destructor is called.
+  */
+  virtual ~CentroidalManager();
+
   /** \brief Reset.
 
       This method should be called once when controller is reset.
@@ -116,6 +158,57 @@ public:
   /** \brief Set anchor frame. */
   void setAnchorFrame();
 
+  /** \brief Set the centroidal manager whose MPC is used while MPC overruns the deadline.
+      \param fallback fallback centroidal manager
+
+      Only MPC of the fallback manager is used, and the other processes (e.g., feedback control and wrench distribution)
+      are continued by this manager.
+  */
+  void setFallback(const std::shared_ptr<CentroidalManager> & fallback);
+
+protected:
+  /** \brief Centroidal plan calculated by MPC.
+
+      DDP returns the input sequence over the horizon in inputList, which is interpolated at the current time in the
+      control thread. The other methods return only the first input, so zmp and forceZ are held until the next plan is
+      applied.
+  */
+  struct MpcPlan
+  {
+    //! Time of the initial state of MPC [sec]
+    double startTime = 0;
+
+    //! CoM used as the initial state of MPC
+    Eigen::Vector3d com = Eigen::Vector3d::Zero();
+
+    //! CoM velocity used as the initial state of MPC
+    Eigen::Vector3d comVel = Eigen::Vector3d::Zero();
+
+    //! Planned horizontal ZMP at startTime
+    Eigen::Vector2d zmp = Eigen::Vector2d::Zero();
+
+    //! Planned force Z at startTime
+    double forceZ = 0;
+
+    //! Planned input sequence [ZMP x, ZMP y, force Z] sampled every inputDt from startTime (empty if not available)
+    std::vector<Eigen::Vector3d> inputList;
+
+    //! Time step of inputList [sec]
+    double inputDt = 0;
+
+    //! Duration to solve MPC [ms]
+    double solveDuration = 0;
+
+    /** \brief Calculate the planned input.
+        \param t time
+        \returns planned input [ZMP x, ZMP y, force Z]
+
+        The input sequence is linearly interpolated, and its last input is held beyond the horizon. If the input
+        sequence is not available, zmp and forceZ are returned.
+    */
+    Eigen::Vector3d calcInput(double t) const;
+  };
+
 protected:
   /** \brief Const accessor to the controller. */
   inline const BaselineWalkingController & ctl() const
@@ -132,15 +225,34 @@ protected:
   /** \brief Accessor to the configuration. */
   virtual Configuration & config() = 0;
 
+  /** \brief Prepare the reference data of MPC.
+
+      This method is called in the control thread before runMpc(), and calculates all the data that runMpc() needs
+      from the foot manager for the initial time mpcTime_. It also copies the configuration that runMpc() needs, since
+      the configuration can be changed by GUI in the control thread. Inherited classes must call this method of the base
+      class in their overrides.
+   */
+  virtual void prepareMpc();
+
   /** \brief Run MPC to plan centroidal trajectory.
 
-      This method calculates plannedZmp_ and plannedForceZ_ from mpcCom_ and mpcComVel_.
+      This method calculates mpcZmp_ and mpcForceZ_ from mpcCom_ and mpcComVel_ at mpcTime_. In asynchronous mode, it
+      is called in the MPC thread, so it must not access the foot manager, the configuration, or the members used in
+      the control thread.
    */
   virtual void runMpc() = 0;
 
   /** \brief Whether to assume that CoM Z is constant. */
   virtual bool isConstantComZ() const = 0;
 
+  /** \brief Set the warm start of MPC.
+      \param zmp horizontal ZMP planned in the previous control cycle
+      \param forceZ force Z planned in the previous control cycle
+
+      This method is called when the MPC method is switched so that the next MPC continues from the current plan.
+   */
+  virtual void setMpcWarmStart(const Eigen::Vector2d & zmp, double forceZ);
+
   /** \brief Calculate anchor frame.
       \param robot robot
    */
@@ -151,15 +263,73 @@ protected:
       \param zmpPlaneHeight height of ZMP plane
       \param zmpPlaneNormal normal of ZMP plane
   */
-  Eigen::Vector3d calcZmp(const std::unordered_map<Foot, sva::ForceVecd> & wrenchList,
+  Eigen::Vector3d calcZmp(const FootMap<sva::ForceVecd> & wrenchList,
                           double zmpPlaneHeight = 0,
                           const Eigen::Vector3d & zmpPlaneNormal = Eigen::Vector3d::UnitZ()) const;
 
   /** \brief Calculate planned CoM acceleration.
+      \param com planned CoM
 
       This method is overridden to support extended CoM-ZMP models (e.g., manipulation forces) in inherited classes.
   */
-  virtual Eigen::Vector3d calcPlannedComAccel() const;
+  virtual Eigen::Vector3d calcPlannedComAccel(const Eigen::Vector3d & com) const;
+
+  /** \brief Run MPC in the control thread and store the result to mpcPlan_. */
+  void updateSyncMpc();
+
+  /** \brief Switch to or from the fallback method according to the MPC computation duration. */
+  void updateFallback();
+
+  /** \brief Switch MPC method.
+      \param useFallback whether to use the fallback method
+  */
+  void switchMpcMethod(bool useFallback);
+
+  /** \brief Request MPC to the MPC thread and apply the published result to mpcPlan_.
+      \param com planned CoM
+      \param comVel planned CoM velocity
+  */
+  void updateAsyncMpc(const Eigen::Vector3d & com, const Eigen::Vector3d & comVel);
+
+  /** \brief Start the thread to run MPC asynchronously. */
+  void startMpcThread();
+
+  /** \brief Stop the thread to run MPC asynchronously. */
+  void stopMpcThread();
+
+  /** \brief Loop of the thread to run MPC asynchronously. */
+  void mpcThread();
+
+  /** \brief Get the wrench distribution corresponding to the contact list from the pool.
+      \param contactList contact list
+
+      A wrench distribution is constructed only the first time each set of contact feet appears. After that, the pooled
+      instance (including its QP solver and QP coefficients) is reused and only its contacts are updated.
+  */
+  std::shared_ptr<WrenchDistribution> getPooledWrenchDist(const FootMap<std::shared_ptr<Contact>> & contactList);
+
+  /** \brief Calculate reference data of MPC over the horizon in a batch.
+      \param horizonDuration horizon duration [sec]
+      \param horizonDt horizon dt [sec]
+      \param withGroundPosZ whether to calculate the reference ground Z position
+
+      The reference data are sampled at mpcTime_ + i * horizonDt and stored in refZmpList_ and refGroundPosZList_.
+  */
+  void calcRefDataList(double horizonDuration, double horizonDt, bool withGroundPosZ);
+
+  /** \brief Get index of the reference data calculated by calcRefDataList.
+      \param t time
+      \returns index of refZmpList_ and refGroundPosZList_ (-1 if t is not on the time grid)
+  */
+  int refDataIdx(double t) const;
+
+  /** \brief Get index of the reference data calculated by calcRefDataList that is nearest to the time.
+      \param t time
+      \returns index of refZmpList_ and refGroundPosZList_ (-1 if the reference data is not calculated)
+
+      This is used in asynchronous mode instead of accessing the foot manager for the time not on the time grid.
+  */
+  int nearestRefDataIdx(double t) const;
 
 protected:
   //! Pointer to controller
@@ -168,12 +338,36 @@ protected:
   //! Robot mass [kg]
   double robotMass_ = 0;
 
+  //! Time of the initial state of MPC [sec]
+  double mpcTime_ = 0;
+
   //! CoM used as the initial state of MPC
   Eigen::Vector3d mpcCom_ = Eigen::Vector3d::Zero();
 
   //! CoM velocity used as the initial state of MPC
   Eigen::Vector3d mpcComVel_ = Eigen::Vector3d::Zero();
 
+  //! Reference CoM Z position used by MPC (copied from the configuration in prepareMpc()) [m]
+  double mpcRefComZ_ = 0;
+
+  //! Whether MPC is run in the MPC thread (copied from the configuration in prepareMpc())
+  bool mpcAsync_ = false;
+
+  //! Horizontal ZMP calculated by MPC
+  Eigen::Vector2d mpcZmp_ = Eigen::Vector2d::Zero();
+
+  //! Force Z calculated by MPC
+  double mpcForceZ_ = 0;
+
+  //! Input sequence [ZMP x, ZMP y, force Z] calculated by MPC (empty if MPC calculates only the first input)
+  std::vector<Eigen::Vector3d> mpcInputList_;
+
+  //! Time step of mpcInputList_ [sec]
+  double mpcInputDt_ = 0;
+
+  //! Plan of MPC applied in the control thread
+  MpcPlan mpcPlan_;
+
   //! Reference ZMP
   Eigen::Vector3d refZmp_ = Eigen::Vector3d::Zero();
 
@@ -192,7 +386,61 @@ protected:
   //! Wrench distribution
   std::shared_ptr<WrenchDistribution> wrenchDist_;
 
+  //! Pool of wrench distribution indexed by the bit set of contact feet
+  std::array<std::shared_ptr<WrenchDistribution>, 4> wrenchDistPool_;
+
   //! Contact list
-  std::unordered_map<Foot, std::shared_ptr<Contact>> contactList_;
+  FootMap<std::shared_ptr<Contact>> contactList_;
+
+  //! Reference ZMP list over the horizon
+  Eigen::Matrix<double, 3, Eigen::Dynamic> refZmpList_;
+
+  //! Reference ground Z position list over the horizon
+  Eigen::VectorXd refGroundPosZList_;
+
+  //! Start time of the reference data list [sec]
+  double refDataStartTime_ = 0;
+
+  //! Time step of the reference data list [sec]
+  double refDataDt_ = 0;
+
+  //! Thread to run MPC asynchronously
+  std::thread mpcThread_;
+
+  //! Whether the MPC thread is running
+  std::atomic<bool> mpcThreadRunning_{false};
+
+  //! Mutex to wait for the MPC request in the MPC thread
+  std::mutex mpcMutex_;
+
+  //! Condition variable to notify the MPC request to the MPC thread
+  std::condition_variable mpcCond_;
+
+  /** \brief Whether MPC is requested to the MPC thread and not finished yet
+
+      While this is true, the members used by runMpc() are owned by the MPC thread.
+  */
+  std::atomic<bool> mpcRequested_{false};
+
+  //! Double buffer of the plan published by the MPC thread
+  std::array<MpcPlan, 2> mpcPlanBuffers_;
+
+  //! Index of the latest published plan in mpcPlanBuffers_
+  std::atomic<size_t> mpcPlanFrontIdx_{0};
+
+  //! Time to request the next MPC in asynchronous mode [sec]
+  double nextMpcRequestTime_ = 0;
+
+  //! Centroidal manager whose MPC is used while MPC overruns the deadline
+  std::shared_ptr<CentroidalManager> fallback_;
+
+  //! Whether the fallback method is used
+  bool fallbackActive_ = false;
+
+  //! Number of consecutive overruns of the deadline
+  int mpcOverrunCount_ = 0;
+
+  //! Time when the MPC method is switched [sec]
+  double mpcSwitchTime_ = 0;
 };
 } // namespace BWC
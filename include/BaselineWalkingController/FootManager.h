@@ -1,7 +1,9 @@
 #pragma once
 
-#include <deque>
-#include <unordered_map>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include <mc_filter/LowPass.h>
 #include <mc_rtc/gui/StateBuilder.h>
@@ -9,6 +11,8 @@
 #include <mc_tasks/ImpedanceGains.h>
 
 #include <BaselineWalkingController/FootTypes.h>
+#include <BaselineWalkingController/FootstepQueue.h>
+#include <BaselineWalkingController/GaitTimeline.h>
 #include <BaselineWalkingController/trajectory/CubicInterpolator.h>
 #include <BaselineWalkingController/trajectory/Func.h>
 
@@ -37,10 +41,13 @@ public:
     double doubleSupportRatio = 0.2;
 
     //! Transformation from foot midpose to each foot pose
-    std::unordered_map<Foot, sva::PTransformd> midToFootTranss = {
+    FootMap<sva::PTransformd> midToFootTranss = {
         {Foot::Left, sva::PTransformd(Eigen::Vector3d(0, 0.1, 0))},
         {Foot::Right, sva::PTransformd(Eigen::Vector3d(0, -0.1, 0))}};
 
+    //! Maximum number of footsteps in the footstep queue
+    int footstepQueueCapacity = 256;
+
     //! Horizon of ZMP trajectory [sec]
     double zmpHorizon = 2.0;
 
@@ -50,6 +57,9 @@ public:
     //! Whether to overwrite landing pose so that the relative pose from support foot to swing foot is retained
     bool overwriteLandingPose = false;
 
+    //! Whether to precompute swing trajectories in a separate thread before swing starts
+    bool precomputeSwingTraj = true;
+
     //! Whether to stop swing trajectory for touch down foot
     bool stopSwingTrajForTouchDownFoot = true;
 
@@ -69,11 +79,13 @@ public:
     double touchDownForceZ = 50; // [N]
     //! @}
 
-    //! Impedance gains for foot tasks
-    std::unordered_map<std::string, mc_tasks::force::ImpedanceGains> impGains = {
-        {"singleSupport", mc_tasks::force::ImpedanceGains::Default()},
-        {"doubleSupport", mc_tasks::force::ImpedanceGains::Default()},
-        {"swing", mc_tasks::force::ImpedanceGains::Default()}};
+    //! Minimum period to update footstep markers in GUI [sec]
+    double footstepMarkerUpdatePeriod = 0.1;
+
+    //! Impedance gains for foot tasks (indexed by ImpGainType)
+    std::array<mc_tasks::force::ImpedanceGains, ImpGainTypes::Num> impGains = {
+        mc_tasks::force::ImpedanceGains::Default(), mc_tasks::force::ImpedanceGains::Default(),
+        mc_tasks::force::ImpedanceGains::Default()};
 
     /** \brief Load mc_rtc configuration.
         \param mcRtcConfig mc_rtc configuration
@@ -88,6 +100,9 @@ public:
   */
   FootManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Destructor. */
+  virtual ~FootManager();
+
   /** \brief Reset.
 
       This method should be called once when controller is reset.
@@ -144,6 +159,24 @@ public:
   */
   bool appendFootstep(const Footstep & newFootstep);
 
+  /** \brief Append a sequence of target footsteps to the queue.
+      \param newFootsteps footsteps to append
+      \return whether newFootsteps are appended
+
+      The whole sequence is validated before the queue is modified, so either all or none of the footsteps are appended.
+  */
+  bool appendFootsteps(const std::vector<Footstep> & newFootsteps);
+
+  /** \brief Replace the footsteps after the specified index in the queue.
+      \param idx index of the first footstep to replace (footsteps before this index are kept)
+      \param newFootsteps footsteps to append after the kept footsteps
+      \return whether the footsteps are replaced
+
+      The whole sequence is validated before the queue is modified, so the queue is unchanged if false is returned. The
+      swinging footstep cannot be replaced.
+  */
+  bool replaceFootstepsFrom(size_t idx, const std::vector<Footstep> & newFootsteps);
+
   /** \brief Calculate reference ZMP.
       \param t time
       \param derivOrder derivative order (0 for original value, 1 for velocity)
@@ -156,28 +189,74 @@ public:
   */
   double calcRefGroundPosZ(double t, int derivOrder = 0) const;
 
+  /** \brief Calculate reference ZMPs over a uniform time grid.
+      \param t0 start time
+      \param dt time step
+      \param refZmpList reference ZMPs at t0, t0 + dt, ... (the number of columns must be set by the caller)
+      \param derivOrder derivative order (0 for original value, 1 for velocity)
+
+      This is equivalent to calling calcRefZmp for each time, but the trajectory segments are searched only once over
+      the grid. Times beyond the end of the trajectory are clamped to the end.
+  */
+  void calcRefZmpList(double t0,
+                      double dt,
+                      Eigen::Matrix<double, 3, Eigen::Dynamic> & refZmpList,
+                      int derivOrder = 0) const;
+
+  /** \brief Calculate reference ground Z positions over a uniform time grid.
+      \param t0 start time
+      \param dt time step
+      \param refGroundPosZList reference ground Z positions at t0, t0 + dt, ... (the size must be set by the caller)
+      \param derivOrder derivative order (0 for original value, 1 for velocity)
+
+      See calcRefZmpList for details.
+  */
+  void calcRefGroundPosZList(double t0, double dt, Eigen::VectorXd & refGroundPosZList, int derivOrder = 0) const;
+
   /** \brief Calculate contact foot poses.
       \param t time
 
       Touch down foot is NOT included.
 
+      \note The returned reference refers to the gait timeline and is invalidated by the next update.
+
       \see FootManager::calcCurrentContactList
   */
-  std::unordered_map<Foot, sva::PTransformd> calcContactFootPoses(double t) const;
+  const FootMap<sva::PTransformd> & calcContactFootPoses(double t) const;
+
+  /** \brief Get the vertices of foot surface represented in the surface frame.
+      \param foot foot
+
+      The vertices are computed in reset() and cached. Call updateLocalVertexLists() if the foot surface is changed.
+  */
+  inline const std::vector<Eigen::Vector3d> & localVertexList(const Foot & foot) const
+  {
+    return localVertexLists_.at(foot);
+  }
+
+  /** \brief Update the cached vertices of foot surfaces.
+
+      This method should be called when the foot surface is changed. The contacts and the support regions in the gait
+      timeline are reconstructed with the new vertices.
+  */
+  void updateLocalVertexLists();
 
   /** \brief Get current contact feet.
 
       If FootManager::Configuration::enableWrenchDistForTouchDownFoot is true, the touch down foot is also included.
   */
-  std::set<Foot> getCurrentContactFeet() const;
+  FootSet getCurrentContactFeet() const;
 
   /** \brief Calculate current contact list.
 
       If FootManager::Configuration::enableWrenchDistForTouchDownFoot is true, the touch down foot is also included.
 
+      The contact instance of each foot is constructed only once and then reused by updating its pose, so that no heap
+      allocation occurs in the steady state.
+
       \see FootManager::calcContactFootPoses
   */
-  std::unordered_map<Foot, std::shared_ptr<Contact>> calcCurrentContactList() const;
+  const FootMap<std::shared_ptr<Contact>> & calcCurrentContactList();
 
   /** \brief Get the support ratio of left foot.
 
@@ -196,21 +275,25 @@ public:
 
       Returns zero if footPoses is empty
   */
-  Eigen::Vector3d calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses) const;
+  Eigen::Vector3d calcZmpWithOffset(const FootMap<sva::PTransformd> & footPoses) const;
 
   /** \brief Access footstep queue. */
-  inline const std::deque<Footstep> & footstepQueue() const noexcept
+  inline const FootstepQueue & footstepQueue() const noexcept
   {
     return footstepQueue_;
   }
 
-  /** \brief Access footstep queue.
+  /** \brief Access footstep queue for modification.
 
       \note Changing footstep queue directly is dangerous and should be avoided if possible. To safely add a footstep to
       footstep queue, call appendFootstep().
+
+      \note Since the footstep queue may be modified through the returned reference, the ZMP trajectory is rebuilt from
+      scratch in the next update. Use footstepQueue() for read-only access.
   */
-  inline std::deque<Footstep> & footstepQueue() noexcept
+  inline FootstepQueue & mutableFootstepQueue() noexcept
   {
+    footstepQueueVersion_++;
     return footstepQueue_;
   }
 
@@ -244,6 +327,74 @@ public:
     return supportPhase_;
   }
 
+  /** \brief Get the gait timeline. */
+  inline const GaitTimeline & gaitTimeline() const noexcept
+  {
+    return gaitTimeline_;
+  }
+
+protected:
+  /** \brief Swing trajectory of a footstep.
+
+      The trajectory is calculated from the swing start pose assumed in advance. Since the position trajectory is linear
+      in its waypoints, it is corrected for the actual swing start pose by adding the sensitivity functions scaled by
+      the errors of the waypoints depending on the swing start pose.
+
+      The members up to startTargetFootPoses are the inputs of the calculation, and are not modified after the
+      calculation is requested.
+  */
+  struct SwingTraj
+  {
+    /** \brief Constructor.
+        \param _handle handle to the footstep
+        \param _footstep footstep
+    */
+    SwingTraj(const FootstepQueue::Handle & _handle, const Footstep & _footstep)
+    : handle(_handle), footstep(_footstep)
+    {
+    }
+
+    /** \brief Whether the trajectory is calculated from the specified inputs.
+        \param _handle handle to the footstep
+        \param _goalPose swing goal pose
+        \param _startTargetFootPoses target foot poses at the swing start
+    */
+    bool isCalculatedFrom(const FootstepQueue::Handle & _handle,
+                          const sva::PTransformd & _goalPose,
+                          const FootMap<sva::PTransformd> & _startTargetFootPoses) const;
+
+    //! Handle to the footstep
+    FootstepQueue::Handle handle;
+
+    //! Footstep
+    Footstep footstep;
+
+    //! Swing start pose assumed in the calculation
+    sva::PTransformd startPose = sva::PTransformd::Identity();
+
+    //! Swing goal pose
+    sva::PTransformd goalPose = sva::PTransformd::Identity();
+
+    //! Target foot poses at the swing start
+    FootMap<sva::PTransformd> startTargetFootPoses;
+
+    //! Waypoints of swing position depending on the swing start pose (start of withdraw, end of withdraw, and middle
+    //! of swing)
+    std::array<Eigen::Vector3d, 3> startWaypoints;
+
+    //! Swing position function
+    std::shared_ptr<PiecewisePolynomial<Eigen::Vector3d, 3>> posFunc;
+
+    //! Sensitivity functions of swing position to startWaypoints (nullptr if not calculated)
+    std::array<std::shared_ptr<PiecewisePolynomial<Eigen::Vector3d, 3>>, 3> posSensitivityFuncs;
+
+    //! Swing rotation function
+    std::shared_ptr<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>> rotFunc;
+
+    //! Base link Yaw function
+    std::shared_ptr<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>> baseYawFunc;
+  };
+
 protected:
   /** \brief Const accessor to the controller. */
   inline const BaselineWalkingController & ctl() const
@@ -257,12 +408,95 @@ protected:
     return *ctlPtr_;
   }
 
+  /** \brief Get the footstep during swing.
+
+      Returns nullptr if no foot is swinging or the swinging footstep has been removed from the queue.
+  */
+  inline const Footstep * swingFootstep() const
+  {
+    return footstepQueue_.get(swingFootstepHandle_);
+  }
+
+  /** \brief Check whether the footsteps can be appended after the specified index in the queue.
+      \param idx index after which the footsteps are appended
+      \param newFootsteps pointer to the first footstep to append
+      \param newFootstepNum number of footsteps to append
+  */
+  bool checkNewFootsteps(size_t idx, const Footstep * newFootsteps, size_t newFootstepNum) const;
+
   /** \brief Update foot tasks. */
   virtual void updateFootTraj();
 
-  /** \brief Update ZMP trajectory. */
+  /** \brief Update footstep markers in GUI.
+
+      The markers are regenerated only when the footstep queue is modified, at most once every
+      Configuration::footstepMarkerUpdatePeriod.
+  */
+  void updateFootstepMarkers();
+
+  /** \brief Calculate swing goal pose.
+      \param footstep footstep
+  */
+  sva::PTransformd calcSwingGoalPose(const Footstep & footstep) const;
+
+  /** \brief Calculate swing trajectory from its inputs.
+      \param swingTraj swing trajectory
+      \param withSensitivity whether to calculate posSensitivityFuncs, which are needed only to correct the trajectory
+      for a start pose different from swingTraj.startPose
+  */
+  static void calcSwingTraj(SwingTraj & swingTraj, bool withSensitivity = true);
+
+  /** \brief Request the swing trajectory of the next footstep to be precomputed.
+
+      This should be called before swing starts. The request is posted only when the inputs of the calculation are
+      changed.
+  */
+  void requestSwingTraj();
+
+  /** \brief Get the swing trajectory of the swinging footstep.
+      \param swingStartPose actual swing start pose
+
+      The precomputed trajectory is used if it is calculated from the current inputs. Otherwise, the trajectory is
+      calculated in place from the actual swing start pose without the sensitivity functions.
+  */
+  std::shared_ptr<SwingTraj> fetchSwingTraj(const sva::PTransformd & swingStartPose);
+
+  /** \brief Start the thread to precompute swing trajectories. */
+  void startSwingTrajThread();
+
+  /** \brief Stop the thread to precompute swing trajectories. */
+  void stopSwingTrajThread();
+
+  /** \brief Loop of the thread to precompute swing trajectories. */
+  void swingTrajThread();
+
+  /** \brief Update gait timeline and ZMP trajectory.
+
+      The gait timeline is maintained as a sliding window: phases of finished footsteps are removed from the front and
+      phases of footsteps entering the horizon are appended to the back. The whole timeline is rebuilt only when the
+      footstep queue is modified in other ways.
+  */
   virtual void updateZmpTraj();
 
+  /** \brief Append phases of the footstep to the gait timeline.
+      \param footstep footstep following the ones already included in the gait timeline
+  */
+  void appendZmpTrajFootstep(const Footstep & footstep);
+
+  /** \brief Append phase to the gait timeline.
+      \param startTime start time of phase
+      \param zmp reference ZMP at the start of phase
+      \param groundPosZ reference ground Z position at the start of phase
+      \param contactFootPoses contact foot poses
+
+      The knots of the phase are also appended to the ZMP and ground Z position functions, which are kept in step with
+      the gait timeline.
+  */
+  void appendGaitPhase(double startTime,
+                       const Eigen::Vector3d & zmp,
+                       double groundPosZ,
+                       const FootMap<sva::PTransformd> & contactFootPoses);
+
   /** \brief Get the remaining duration for next touch down.
 
       Returns zero in double support phase. */
@@ -281,56 +515,128 @@ protected:
   BaselineWalkingController * ctlPtr_ = nullptr;
 
   //! Footstep queue
-  std::deque<Footstep> footstepQueue_;
+  FootstepQueue footstepQueue_;
 
   //! Previous footstep
   std::shared_ptr<Footstep> prevFootstep_;
 
   //! Target foot pose represented in world frame
-  std::unordered_map<Foot, sva::PTransformd> targetFootPoses_;
+  FootMap<sva::PTransformd> targetFootPoses_;
 
   //! Target foot velocity represented in world frame
-  std::unordered_map<Foot, sva::MotionVecd> targetFootVels_;
+  FootMap<sva::MotionVecd> targetFootVels_;
 
   //! Target foot acceleration represented in world frame
-  std::unordered_map<Foot, sva::MotionVecd> targetFootAccels_;
+  FootMap<sva::MotionVecd> targetFootAccels_;
 
   //! Foot poses in the last double support phase
-  std::unordered_map<Foot, sva::PTransformd> lastDoubleSupportFootPoses_;
+  FootMap<sva::PTransformd> lastDoubleSupportFootPoses_;
 
   //! Support phase
   SupportPhase supportPhase_ = SupportPhase::DoubleSupport;
 
-  //! ZMP function
+  //! ZMP function (its points are kept in step with gaitTimeline_)
   std::shared_ptr<CubicInterpolator<Eigen::Vector3d>> zmpFunc_;
 
-  //! Ground Z position function
+  //! Ground Z position function (its points are kept in step with gaitTimeline_)
   std::shared_ptr<CubicInterpolator<double>> groundPosZFunc_;
 
-  //! Contact foot poses list
-  std::map<double, std::unordered_map<Foot, sva::PTransformd>> contactFootPosesList_;
+  //! Gait timeline
+  GaitTimeline gaitTimeline_;
+
+  //! Vertices of foot surface represented in the surface frame
+  FootMap<std::vector<Eigen::Vector3d>> localVertexLists_;
+
+  //! Version of footstep queue, which is incremented when the queue is modified other than by appendFootstep() and
+  //! removal of finished footsteps
+  unsigned int footstepQueueVersion_ = 0;
+
+  //! Version of footstep queue from which the gait timeline is built
+  unsigned int zmpTrajVersion_ = 0;
+
+  //! Number of footsteps from the front of footstep queue whose phases are included in the gait timeline
+  size_t zmpTrajFootstepNum_ = 0;
+
+  //! Foot poses at the end of the footsteps included in the gait timeline
+  FootMap<sva::PTransformd> zmpTrajEndFootPoses_;
 
-  //! Footstep during swing
-  const Footstep * swingFootstep_ = nullptr;
+  //! Handle to the footstep during swing
+  FootstepQueue::Handle swingFootstepHandle_;
 
   //! Swing foot trajectory
   //! @{
-  std::shared_ptr<PiecewiseFunc<Eigen::Vector3d>> swingPosFunc_;
+  std::shared_ptr<PiecewisePolynomial<Eigen::Vector3d, 3>> swingPosFunc_;
   std::shared_ptr<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>> swingRotFunc_;
   //! @}
 
   //! Base link Yaw trajectory
   std::shared_ptr<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>> baseYawFunc_;
 
+  //! Thread to precompute swing trajectories
+  std::thread swingTrajThread_;
+
+  //! Whether swingTrajThread_ is running
+  std::atomic<bool> swingTrajThreadRunning_{false};
+
+  //! Mutex for swingTrajRequest_ and swingTrajResult_
+  std::mutex swingTrajMutex_;
+
+  //! Condition variable to notify the swing trajectory request to the thread
+  std::condition_variable swingTrajCond_;
+
+  //! Swing trajectory to be calculated by swingTrajThread_
+  std::shared_ptr<SwingTraj> swingTrajRequest_;
+
+  //! Swing trajectory calculated by swingTrajThread_
+  std::shared_ptr<SwingTraj> swingTrajResult_;
+
+  //! Swing trajectory lastly requested (only the inputs are accessed)
+  std::shared_ptr<const SwingTraj> lastSwingTrajRequest_;
+
   //! Whether touch down is detected during swing
   bool touchDown_ = false;
 
+  //! Contact of each foot (reused by updating the pose)
+  FootMap<std::shared_ptr<Contact>> footContacts_;
+
+  //! Current contact list
+  FootMap<std::shared_ptr<Contact>> currentContactList_;
+
   //! Types of impedance gains
-  std::unordered_map<Foot, std::string> impGainTypes_;
+  FootMap<ImpGainType> impGainTypes_;
 
   //! Whether to require updating impedance gains
   bool requireImpGainUpdate_ = true;
 
+  /** \brief Triple buffer of footstep marker polygons
+
+      The back buffer is written by the control thread and the front buffer is read by GUI. The middle buffer is
+      exchanged with the back buffer after writing and with the front buffer before reading when it is fresh, so that
+      neither side touches the buffer owned by the other.
+  */
+  std::array<std::vector<std::vector<Eigen::Vector3d>>, 3> footstepMarkerBuffers_;
+
+  //! Index of the footstep marker buffer written by the control thread
+  size_t footstepMarkerBackIdx_ = 0;
+
+  //! Index of the middle footstep marker buffer (footstepMarkerFreshBit is set when it has not been read yet)
+  std::atomic<size_t> footstepMarkerMiddleIdx_{1};
+
+  //! Index of the footstep marker buffer read by GUI (accessed only by GUI)
+  size_t footstepMarkerFrontIdx_ = 2;
+
+  //! Flag in footstepMarkerMiddleIdx_ indicating that the middle buffer has been written and not read yet
+  static constexpr size_t footstepMarkerFreshBit = 4;
+
+  //! Revision of footstep queue from which the footstep markers are generated
+  uint64_t footstepMarkerQueueRevision_ = 0;
+
+  //! Version of footstep queue from which the footstep markers are generated
+  unsigned int footstepMarkerQueueVersion_ = 0;
+
+  //! Time when the footstep markers are updated [sec]
+  double footstepMarkerUpdateTime_ = 0;
+
   //! Low-pass filter for the overwrite amount of landing position
   mc_filter::LowPass<Eigen::Vector3d> overwriteLandingPosLowPass_ = mc_filter::LowPass<Eigen::Vector3d>(0.005, 1.0);
 };
@@ -1,6 +1,9 @@
 #pragma once
 
-#include <set>
+#include <array>
+#include <initializer_list>
+#include <stdexcept>
+#include <utility>
 
 #include <mc_rtc/Configuration.h>
 
@@ -18,10 +21,402 @@ enum class Foot
 
 namespace Feet
 {
+//! Number of feet
+constexpr size_t Num = 2;
+
 //! Both feet
-const std::set<Foot> Both = {Foot::Left, Foot::Right};
+constexpr std::array<Foot, Num> Both = {Foot::Left, Foot::Right};
 } // namespace Feet
 
+/** \brief Set of feet.
+
+    The set is represented by a bitmask, so no heap allocation occurs. Feet are iterated in the order of Feet::Both.
+*/
+class FootSet
+{
+public:
+  /** \brief Iterator over the feet in the set. */
+  class Iterator
+  {
+  public:
+    /** \brief Constructor.
+        \param bits bitmask of the set
+        \param idx foot index
+    */
+    constexpr Iterator(unsigned int bits, size_t idx) : bits_(bits), idx_(idx)
+    {
+      skipAbsent();
+    }
+
+    /** \brief Dereference operator. */
+    constexpr Foot operator*() const
+    {
+      return static_cast<Foot>(idx_);
+    }
+
+    /** \brief Increment operator. */
+    constexpr Iterator & operator++()
+    {
+      idx_++;
+      skipAbsent();
+      return *this;
+    }
+
+    /** \brief Inequality operator. */
+    constexpr bool operator!=(const Iterator & other) const
+    {
+      return idx_ != other.idx_;
+    }
+
+  protected:
+    /** \brief Move to the next foot in the set. */
+    constexpr void skipAbsent()
+    {
+      while(idx_ < Feet::Num && !((bits_ >> idx_) & 1u))
+      {
+        idx_++;
+      }
+    }
+
+  protected:
+    //! Bitmask of the set
+    unsigned int bits_;
+
+    //! Foot index
+    size_t idx_;
+  };
+
+public:
+  /** \brief Constructor.
+      \param feet feet in the set
+  */
+  constexpr FootSet(std::initializer_list<Foot> feet = {})
+  {
+    for(const auto & foot : feet)
+    {
+      insert(foot);
+    }
+  }
+
+  /** \brief Add foot. */
+  constexpr void insert(Foot foot)
+  {
+    bits_ |= bit(foot);
+  }
+
+  /** \brief Remove foot. */
+  constexpr void erase(Foot foot)
+  {
+    bits_ &= ~bit(foot);
+  }
+
+  /** \brief Remove all feet. */
+  constexpr void clear()
+  {
+    bits_ = 0;
+  }
+
+  /** \brief Get 1 if the foot is in the set, 0 otherwise. */
+  constexpr size_t count(Foot foot) const
+  {
+    return (bits_ & bit(foot)) ? 1 : 0;
+  }
+
+  /** \brief Get the number of feet in the set. */
+  constexpr size_t size() const
+  {
+    size_t num = 0;
+    for(size_t i = 0; i < Feet::Num; i++)
+    {
+      num += (bits_ >> i) & 1u;
+    }
+    return num;
+  }
+
+  /** \brief Whether the set is empty. */
+  constexpr bool empty() const
+  {
+    return bits_ == 0;
+  }
+
+  /** \brief Get the bitmask, where the i-th bit corresponds to the foot with the underlying value i. */
+  constexpr unsigned int bits() const
+  {
+    return bits_;
+  }
+
+  /** \brief Get the iterator to the first foot. */
+  constexpr Iterator begin() const
+  {
+    return Iterator(bits_, 0);
+  }
+
+  /** \brief Get the iterator past the last foot. */
+  constexpr Iterator end() const
+  {
+    return Iterator(bits_, Feet::Num);
+  }
+
+protected:
+  /** \brief Get the bit of the foot. */
+  static constexpr unsigned int bit(Foot foot)
+  {
+    return 1u << static_cast<size_t>(foot);
+  }
+
+protected:
+  //! Bitmask
+  unsigned int bits_ = 0;
+};
+
+/** \brief Map from foot to value.
+
+    \tparam T value type
+
+    Drop-in replacement of std::unordered_map<Foot, T> backed by a fixed-size array with a presence bitmask, so that
+    element access does not hash and insertion does not allocate. Elements are iterated in the order of Feet::Both.
+*/
+template<class T>
+class FootMap
+{
+public:
+  //! Element type
+  using value_type = std::pair<Foot, T>;
+
+  /** \brief Iterator over the present elements.
+      \tparam MapType (const) map type
+      \tparam ValueType (const) element type
+  */
+  template<class MapType, class ValueType>
+  class Iterator
+  {
+  public:
+    /** \brief Constructor.
+        \param map map
+        \param idx element index
+    */
+    Iterator(MapType * map, size_t idx) : map_(map), idx_(idx)
+    {
+      skipAbsent();
+    }
+
+    /** \brief Dereference operator. */
+    ValueType & operator*() const
+    {
+      return map_->data_[idx_];
+    }
+
+    /** \brief Arrow operator. */
+    ValueType * operator->() const
+    {
+      return &(map_->data_[idx_]);
+    }
+
+    /** \brief Increment operator. */
+    Iterator & operator++()
+    {
+      idx_++;
+      skipAbsent();
+      return *this;
+    }
+
+    /** \brief Equality operator. */
+    bool operator==(const Iterator & other) const
+    {
+      return idx_ == other.idx_;
+    }
+
+    /** \brief Inequality operator. */
+    bool operator!=(const Iterator & other) const
+    {
+      return idx_ != other.idx_;
+    }
+
+  protected:
+    /** \brief Move to the next present element. */
+    void skipAbsent()
+    {
+      while(idx_ < Feet::Num && !map_->feet_.count(static_cast<Foot>(idx_)))
+      {
+        idx_++;
+      }
+    }
+
+  protected:
+    //! Map
+    MapType * map_;
+
+    //! Element index
+    size_t idx_;
+  };
+
+  //! Iterator
+  using iterator = Iterator<FootMap, value_type>;
+
+  //! Const iterator
+  using const_iterator = Iterator<const FootMap, const value_type>;
+
+public:
+  /** \brief Constructor.
+      \param elements initial elements
+  */
+  FootMap(std::initializer_list<value_type> elements = {})
+  {
+    for(size_t i = 0; i < Feet::Num; i++)
+    {
+      data_[i].first = static_cast<Foot>(i);
+    }
+    for(const auto & element : elements)
+    {
+      emplace(element.first, element.second);
+    }
+  }
+
+  /** \brief Access the element of the foot.
+
+      Throws std::out_of_range if the element does not exist.
+  */
+  T & at(Foot foot)
+  {
+    checkFoot(foot);
+    return data_[static_cast<size_t>(foot)].second;
+  }
+
+  /** \brief Const access the element of the foot.
+
+      Throws std::out_of_range if the element does not exist.
+  */
+  const T & at(Foot foot) const
+  {
+    checkFoot(foot);
+    return data_[static_cast<size_t>(foot)].second;
+  }
+
+  /** \brief Access the element of the foot, default-constructing it if it does not exist. */
+  T & operator[](Foot foot)
+  {
+    if(!feet_.count(foot))
+    {
+      feet_.insert(foot);
+      data_[static_cast<size_t>(foot)].second = T{};
+    }
+    return data_[static_cast<size_t>(foot)].second;
+  }
+
+  /** \brief Add the element if the foot does not exist.
+      \param foot foot
+      \param value value
+
+      Returns true if the element is added. As with std::unordered_map, an existing element is not overwritten.
+  */
+  bool emplace(Foot foot, const T & value)
+  {
+    if(feet_.count(foot))
+    {
+      return false;
+    }
+    feet_.insert(foot);
+    data_[static_cast<size_t>(foot)].second = value;
+    return true;
+  }
+
+  /** \brief Remove the element of the foot. */
+  void erase(Foot foot)
+  {
+    if(feet_.count(foot))
+    {
+      feet_.erase(foot);
+      data_[static_cast<size_t>(foot)].second = T{};
+    }
+  }
+
+  /** \brief Remove all elements. */
+  void clear()
+  {
+    for(const auto & foot : Feet::Both)
+    {
+      erase(foot);
+    }
+  }
+
+  /** \brief Get 1 if the element of the foot exists, 0 otherwise. */
+  size_t count(Foot foot) const
+  {
+    return feet_.count(foot);
+  }
+
+  /** \brief Get the number of elements. */
+  size_t size() const
+  {
+    return feet_.size();
+  }
+
+  /** \brief Whether the map is empty. */
+  bool empty() const
+  {
+    return feet_.empty();
+  }
+
+  /** \brief Get the set of feet whose elements exist. */
+  const FootSet & feet() const noexcept
+  {
+    return feet_;
+  }
+
+  /** \brief Find the element of the foot, returning end() if it does not exist. */
+  iterator find(Foot foot)
+  {
+    return feet_.count(foot) ? iterator(this, static_cast<size_t>(foot)) : end();
+  }
+
+  /** \brief Find the element of the foot, returning end() if it does not exist. */
+  const_iterator find(Foot foot) const
+  {
+    return feet_.count(foot) ? const_iterator(this, static_cast<size_t>(foot)) : end();
+  }
+
+  /** \brief Get the iterator to the first element. */
+  iterator begin()
+  {
+    return iterator(this, 0);
+  }
+
+  /** \brief Get the iterator past the last element. */
+  iterator end()
+  {
+    return iterator(this, Feet::Num);
+  }
+
+  /** \brief Get the const iterator to the first element. */
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  /** \brief Get the const iterator past the last element. */
+  const_iterator end() const
+  {
+    return const_iterator(this, Feet::Num);
+  }
+
+protected:
+  /** \brief Throw std::out_of_range if the element of the foot does not exist. */
+  void checkFoot(Foot foot) const
+  {
+    if(!feet_.count(foot))
+    {
+      throw std::out_of_range("[FootMap] Element does not exist: " + std::to_string(static_cast<int>(foot)));
+    }
+  }
+
+protected:
+  //! Elements indexed by foot
+  std::array<value_type, Feet::Num> data_;
+
+  //! Feet whose elements exist
+  FootSet feet_;
+};
+
 /** \brief Convert string to foot. */
 Foot strToFoot(const std::string & footStr);
 
@@ -47,6 +442,29 @@ enum class SupportPhase
   RightSupport
 };
 
+/** \brief Type of impedance gains of foot task. */
+enum class ImpGainType
+{
+  //! Gains of support foot in single support phase
+  SingleSupport = 0,
+
+  //! Gains of both feet in double support phase
+  DoubleSupport,
+
+  //! Gains of swing foot
+  Swing
+};
+
+namespace ImpGainTypes
+{
+//! Number of impedance gain types
+constexpr size_t Num = 3;
+
+//! All impedance gain types
+constexpr std::array<ImpGainType, Num> All = {ImpGainType::SingleSupport, ImpGainType::DoubleSupport,
+                                              ImpGainType::Swing};
+} // namespace ImpGainTypes
+
 /** \brief Footstep. */
 struct Footstep
 {
@@ -123,4 +541,7 @@ std::string to_string(const BWC::Foot & foot);
 
 /** \brief Convert support phase to string. */
 std::string to_string(const BWC::SupportPhase & phase);
+
+/** \brief Convert impedance gain type to string. */
+std::string to_string(const BWC::ImpGainType & impGainType);
 } // namespace std
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include <BaselineWalkingController/FootTypes.h>
+
+namespace BWC
+{
+/** \brief Footstep queue.
+
+    Fixed-capacity ring buffer of footsteps. All storage is allocated in the constructor, so pushing, popping, and
+    truncating footsteps do not allocate.
+
+    Each pushed footstep is identified by a unique ID, so a handle to a footstep stays valid until the footstep is
+    removed from the queue or overwritten, and is never confused with a footstep pushed later to the same slot.
+
+    The queue is accessed only from the control thread, except for size(), which is an atomic load without ordering
+    guarantees and can be used as a hint from any thread. The footsteps themselves must not be read from other threads;
+    they should be copied in the control thread and handed over (e.g., as the footstep markers of FootManager).
+*/
+class FootstepQueue
+{
+public:
+  /** \brief Handle to a footstep in the queue. */
+  struct Handle
+  {
+    //! Slot index of the ring buffer
+    size_t slot = 0;
+
+    //! Footstep ID (zero for invalid handle)
+    uint64_t id = 0;
+
+    /** \brief Equality operator. */
+    bool operator==(const Handle & other) const
+    {
+      return slot == other.slot && id == other.id;
+    }
+
+    /** \brief Inequality operator. */
+    bool operator!=(const Handle & other) const
+    {
+      return !(*this == other);
+    }
+  };
+
+  /** \brief Const iterator from the front to the back. */
+  class ConstIterator
+  {
+  public:
+    /** \brief Constructor.
+        \param queue footstep queue
+        \param idx index from the front
+    */
+    ConstIterator(const FootstepQueue * queue, size_t idx) : queue_(queue), idx_(idx) {}
+
+    /** \brief Dereference operator. */
+    const Footstep & operator*() const
+    {
+      return (*queue_)[idx_];
+    }
+
+    /** \brief Arrow operator. */
+    const Footstep * operator->() const
+    {
+      return &((*queue_)[idx_]);
+    }
+
+    /** \brief Increment operator. */
+    ConstIterator & operator++()
+    {
+      idx_++;
+      return *this;
+    }
+
+    /** \brief Inequality operator. */
+    bool operator!=(const ConstIterator & other) const
+    {
+      return idx_ != other.idx_;
+    }
+
+  protected:
+    //! Footstep queue
+    const FootstepQueue * queue_;
+
+    //! Index from the front
+    size_t idx_;
+  };
+
+public:
+  /** \brief Constructor.
+      \param capacity maximum number of footsteps
+  */
+  FootstepQueue(size_t capacity = 256);
+
+  /** \brief Reallocate the storage and remove all footsteps.
+      \param capacity maximum number of footsteps
+
+      This method allocates memory and should not be called in the control loop.
+  */
+  void reset(size_t capacity);
+
+  /** \brief Get the maximum number of footsteps. */
+  inline size_t capacity() const noexcept
+  {
+    return slots_.size();
+  }
+
+  /** \brief Get the number of footsteps.
+
+      This can be called from any thread.
+  */
+  inline size_t size() const noexcept
+  {
+    return size_.load(std::memory_order_relaxed);
+  }
+
+  /** \brief Whether the queue is empty. */
+  inline bool empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  /** \brief Whether the queue is full. */
+  inline bool full() const noexcept
+  {
+    return size() == capacity();
+  }
+
+  /** \brief Get the revision, which is incremented every time the queue is modified. */
+  inline uint64_t revision() const noexcept
+  {
+    return revision_;
+  }
+
+  /** \brief Access the footstep.
+      \param idx index from the front
+  */
+  inline const Footstep & operator[](size_t idx) const
+  {
+    return slots_[slotIdx(idx)];
+  }
+
+  /** \brief Access the first footstep. */
+  inline const Footstep & front() const
+  {
+    return (*this)[0];
+  }
+
+  /** \brief Access the last footstep. */
+  inline const Footstep & back() const
+  {
+    return (*this)[size() - 1];
+  }
+
+  /** \brief Get the iterator to the first footstep. */
+  inline ConstIterator begin() const
+  {
+    return ConstIterator(this, 0);
+  }
+
+  /** \brief Get the iterator past the last footstep. */
+  inline ConstIterator end() const
+  {
+    return ConstIterator(this, size());
+  }
+
+  /** \brief Add the footstep to the back.
+      \param footstep footstep
+      \return whether the footstep is added (false if the queue is full)
+  */
+  bool push_back(const Footstep & footstep);
+
+  /** \brief Add the footsteps to the back.
+      \param footsteps footsteps
+      \return whether the footsteps are added (false if the queue does not have enough space)
+
+      Either all or none of the footsteps are added.
+  */
+  bool append(const std::vector<Footstep> & footsteps);
+
+  /** \brief Replace the footsteps after the specified index.
+      \param idx index of the first footstep to replace (footsteps before this index are kept)
+      \param footsteps footsteps to add after the kept footsteps
+      \return whether the footsteps are replaced (false if idx is out of the queue or the queue does not have enough
+      space)
+
+      The removal and addition are done in a single modification, so the revision is incremented only once.
+  */
+  bool replaceFrom(size_t idx, const std::vector<Footstep> & footsteps);
+
+  /** \brief Remove the first footstep. */
+  void pop_front();
+
+  /** \brief Remove the footsteps from the back so that the number of footsteps is not greater than the specified size.
+      \param size number of footsteps to keep
+  */
+  void truncate(size_t size);
+
+  /** \brief Remove all footsteps. */
+  void clear();
+
+  /** \brief Overwrite the footstep.
+      \param idx index from the front
+      \param footstep footstep
+
+      A new ID is assigned to the overwritten footstep, so the handles to the old footstep are invalidated.
+  */
+  void set(size_t idx, const Footstep & footstep);
+
+  /** \brief Get the handle to the footstep.
+      \param idx index from the front
+  */
+  inline Handle handle(size_t idx) const
+  {
+    size_t slot = slotIdx(idx);
+    return Handle{slot, ids_[slot]};
+  }
+
+  /** \brief Get the footstep of the handle.
+      \param handle handle
+
+      Returns nullptr if the footstep of the handle has been removed from the queue.
+  */
+  const Footstep * get(const Handle & handle) const;
+
+protected:
+  /** \brief Get the slot index of the ring buffer.
+      \param idx index from the front
+  */
+  inline size_t slotIdx(size_t idx) const
+  {
+    size_t slot = head_ + idx;
+    return slot < capacity() ? slot : slot - capacity();
+  }
+
+protected:
+  //! Footsteps in the ring buffer
+  std::vector<Footstep> slots_;
+
+  //! Footstep IDs of the slots
+  std::vector<uint64_t> ids_;
+
+  //! Slot index of the first footstep
+  size_t head_ = 0;
+
+  //! Number of footsteps (atomic so that size() can be called from any thread)
+  std::atomic<size_t> size_{0};
+
+  //! ID assigned to the next footstep
+  uint64_t nextId_ = 1;
+
+  //! Revision incremented every time the queue is modified
+  uint64_t revision_ = 0;
+};
+} // namespace BWC
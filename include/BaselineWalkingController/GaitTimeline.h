@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+
+#include <SpaceVecAlg/SpaceVecAlg>
+
+#include <BaselineWalkingController/FootTypes.h>
+
+namespace BWC
+{
+/** \brief Phase of gait timeline.
+
+    A phase lasts from its start time to the start time of the next phase. The reference ZMP and ground Z position are
+    the values at the start of the phase, which are interpolated with the values of the next phase.
+*/
+struct GaitPhase
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! Start time of phase [sec]
+  double startTime = 0;
+
+  //! Reference ZMP at the start of phase
+  Eigen::Vector3d zmp = Eigen::Vector3d::Zero();
+
+  //! Reference ground Z position at the start of phase
+  double groundPosZ = 0;
+
+  //! Contact foot poses (touch down foot is NOT included)
+  FootMap<sva::PTransformd> contactFootPoses;
+
+  //! Minimum horizontal position of the vertices of contact feet (i.e., lower bound of support region)
+  Eigen::Vector2d supportRegionMin = Eigen::Vector2d::Zero();
+
+  //! Maximum horizontal position of the vertices of contact feet (i.e., upper bound of support region)
+  Eigen::Vector2d supportRegionMax = Eigen::Vector2d::Zero();
+};
+
+/** \brief Gait timeline.
+
+    Time-sorted list of gait phases compiled from the footstep queue. This is the common source of the reference ZMP,
+    ground Z position, contact foot poses, and support region used by the managers.
+*/
+class GaitTimeline
+{
+public:
+  /** \brief Clear phases. */
+  void clear();
+
+  /** \brief Add phase.
+      \param phase phase
+
+      The phase is inserted so that the start times are kept in ascending order. If the phase with the same start time
+      already exists, the new phase is ignored.
+  */
+  void appendPhase(const GaitPhase & phase);
+
+  /** \brief Remove phases whose start time is less than the specified time.
+      \param t time
+  */
+  void removePhasesBefore(double t);
+
+  /** \brief Remove phases whose start time is greater than the specified time.
+      \param t time
+  */
+  void removePhasesAfter(double t);
+
+  /** \brief Get the index of the phase containing the time.
+      \param t time
+
+      Returns -1 if the time is before the start time of the first phase. The last phase is assumed to last forever.
+  */
+  int phaseIdx(double t) const;
+
+  /** \brief Get phase.
+      \param idx phase index
+  */
+  inline const GaitPhase & phase(size_t idx) const
+  {
+    return phases_[idx];
+  }
+
+  /** \brief Get phase list. */
+  inline const std::vector<GaitPhase> & phases() const noexcept
+  {
+    return phases_;
+  }
+
+  /** \brief Get the number of phases. */
+  inline size_t size() const noexcept
+  {
+    return phases_.size();
+  }
+
+  /** \brief Whether there is no phase. */
+  inline bool empty() const noexcept
+  {
+    return phases_.empty();
+  }
+
+protected:
+  //! Phase list sorted by start time
+  std::vector<GaitPhase> phases_;
+};
+} // namespace BWC
@@ -26,6 +26,13 @@ public:
     //! DDP maximum iteration
     int ddpMaxIter = 1;
 
+    /** \brief DDP maximum computation duration per control cycle [ms]
+
+        If positive, DDP is iterated one at a time up to ddpMaxIter, and stops when the next iteration is expected to
+        exceed this duration.
+    */
+    double ddpMaxComputationDuration = 0;
+
     /** \brief Load mc_rtc configuration. */
     virtual void load(const mc_rtc::Configuration & mcRtcConfig) override;
   };
@@ -37,6 +44,12 @@ public:
    */
   CentroidalManagerDdpZmp(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Destructor.
+
+      The MPC thread is stopped here, since it may run runMpc() using the members of this class.
+   */
+  virtual ~CentroidalManagerDdpZmp();
+
   /** \brief Reset.
 
       This method should be called once when controller is reset.
@@ -59,9 +72,12 @@ protected:
     return config_;
   }
 
+  /** \brief Prepare the reference data of MPC. */
+  virtual void prepareMpc() override;
+
   /** \brief Run MPC to plan centroidal trajectory.
 
-      This method calculates plannedZmp_ and plannedForceZ_ from mpcCom_ and mpcComVel_.
+      This method calculates mpcZmp_ and mpcForceZ_ from mpcCom_ and mpcComVel_ at mpcTime_.
    */
   virtual void runMpc() override;
 
@@ -74,11 +90,34 @@ protected:
   /** \brief Calculate reference data of MPC. */
   CCC::DdpZmp::RefData calcRefData(double t) const;
 
+  /** \brief Calculate the initial guess of the input sequence of DDP.
+      \param uList input sequence
+
+      The input sequence of the previous solve is shifted by the elapsed time and resampled. The inputs beyond the
+      previous horizon are calculated from the reference ZMP.
+   */
+  void calcInitialInputList(std::vector<CCC::DdpZmp::DdpProblem::InputDimVector> & uList) const;
+
 protected:
   //! Configuration
   Configuration config_;
 
   //! DDP
   std::shared_ptr<CCC::DdpZmp> ddp_;
+
+  //! DDP maximum iteration used by MPC (copied from the configuration in prepareMpc())
+  int mpcDdpMaxIter_ = 1;
+
+  //! DDP maximum computation duration used by MPC (copied from the configuration in prepareMpc()) [ms]
+  double mpcDdpMaxComputationDuration_ = 0;
+
+  //! Initial time of the previous DDP solve [sec]
+  double prevMpcTime_ = 0;
+
+  //! Number of DDP iterations in the previous solve
+  int ddpIter_ = 0;
+
+  //! Total computation duration of the previous DDP solve including all iterations [ms]
+  double ddpComputationDuration_ = 0;
 };
 } // namespace BWC
@@ -29,6 +29,12 @@ public:
   CentroidalManagerFootGuidedControl(BaselineWalkingController * ctlPtr,
                                      const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Destructor.
+
+      The MPC thread is stopped here, since it may run runMpc() using the members of this class.
+   */
+  virtual ~CentroidalManagerFootGuidedControl();
+
   /** \brief Reset.
 
       This method should be called once when controller is reset.
@@ -51,9 +57,12 @@ protected:
     return config_;
   }
 
+  /** \brief Prepare the reference data of MPC. */
+  virtual void prepareMpc() override;
+
   /** \brief Run MPC to plan centroidal trajectory.
 
-      This method calculates plannedZmp_ and plannedForceZ_ from mpcCom_ and mpcComVel_.
+      This method calculates mpcZmp_ and mpcForceZ_ from mpcCom_ and mpcComVel_ at mpcTime_.
    */
   virtual void runMpc() override;
 
@@ -72,5 +81,8 @@ protected:
 
   //! Foot-guided control
   std::shared_ptr<CCC::FootGuidedControl> footGuided_;
+
+  //! Reference data of MPC
+  CCC::FootGuidedControl::RefData refData_;
 };
 } // namespace BWC
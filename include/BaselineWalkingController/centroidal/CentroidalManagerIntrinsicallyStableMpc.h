@@ -38,6 +38,12 @@ public:
   CentroidalManagerIntrinsicallyStableMpc(BaselineWalkingController * ctlPtr,
                                           const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Destructor.
+
+      The MPC thread is stopped here, since it may run runMpc() using the members of this class.
+   */
+  virtual ~CentroidalManagerIntrinsicallyStableMpc();
+
   /** \brief Reset.
 
       This method should be called once when controller is reset.
@@ -60,9 +66,18 @@ protected:
     return config_;
   }
 
+  /** \brief Set the warm start of MPC.
+      \param zmp horizontal ZMP planned in the previous control cycle
+      \param forceZ force Z planned in the previous control cycle
+   */
+  virtual void setMpcWarmStart(const Eigen::Vector2d & zmp, double forceZ) override;
+
+  /** \brief Prepare the reference data of MPC. */
+  virtual void prepareMpc() override;
+
   /** \brief Run MPC to plan centroidal trajectory.
 
-      This method calculates plannedZmp_ and plannedForceZ_ from mpcCom_ and mpcComVel_.
+      This method calculates mpcZmp_ and mpcForceZ_ from mpcCom_ and mpcComVel_ at mpcTime_.
    */
   virtual void runMpc() override;
 
@@ -75,6 +90,17 @@ protected:
   /** \brief Calculate reference data of MPC. */
   CCC::IntrinsicallyStableMpc::RefData calcRefData(double t) const;
 
+  /** \brief Calculate the ZMP limits of each sample of reference data and the ZMP limits at mpcTime_.
+
+      This method should be called after CentroidalManager::calcRefDataList.
+   */
+  void calcRefZmpLimitsList();
+
+  /** \brief Calculate ZMP limits.
+      \param phaseIdx index of gait phase (-1 for no contact)
+   */
+  std::array<Eigen::Vector2d, 2> calcZmpLimits(int phaseIdx) const;
+
 protected:
   //! Configuration
   Configuration config_;
@@ -84,5 +110,11 @@ protected:
 
   //! Whether it is the first iteration
   bool firstIter_ = true;
+
+  //! ZMP limits (min and max) of each sample of reference data
+  std::vector<std::array<Eigen::Vector2d, 2>> refZmpLimitsList_;
+
+  //! ZMP limits (min and max) at the initial time of MPC
+  std::array<Eigen::Vector2d, 2> zmpLimits_ = {Eigen::Vector2d::Zero(), Eigen::Vector2d::Zero()};
 };
 } // namespace BWC
@@ -35,6 +35,12 @@ public:
   CentroidalManagerPreviewControlZmp(BaselineWalkingController * ctlPtr,
                                      const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Destructor.
+
+      The MPC thread is stopped here, since it may run runMpc() using the members of this class.
+   */
+  virtual ~CentroidalManagerPreviewControlZmp();
+
   /** \brief Reset.
 
       This method should be called once when controller is reset.
@@ -54,9 +60,18 @@ protected:
     return config_;
   }
 
+  /** \brief Set the warm start of MPC.
+      \param zmp horizontal ZMP planned in the previous control cycle
+      \param forceZ force Z planned in the previous control cycle
+   */
+  virtual void setMpcWarmStart(const Eigen::Vector2d & zmp, double forceZ) override;
+
+  /** \brief Prepare the reference data of MPC. */
+  virtual void prepareMpc() override;
+
   /** \brief Run MPC to plan centroidal trajectory.
 
-      This method calculates plannedZmp_ and plannedForceZ_ from mpcCom_ and mpcComVel_.
+      This method calculates mpcZmp_ and mpcForceZ_ from mpcCom_ and mpcComVel_ at mpcTime_.
    */
   virtual void runMpc() override;
 
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <mutex>
 #include <thread>
 
 #include <BaselineFootstepPlanner/FootstepPlanner.h>
 
+#include <BaselineWalkingController/FootTypes.h>
 #include <BaselineWalkingController/State.h>
 
 namespace BFP
@@ -44,6 +46,12 @@ protected:
   //! Thread for footstep planning
   std::thread planningThread_;
 
+  //! Mutex of the planned footstep list
+  std::mutex plannedFootstepMutex_;
+
+  //! Footsteps planned in the planning thread and not submitted to the foot manager yet
+  std::vector<Footstep> plannedFootstepList_;
+
   //! Whether planning and walking is triggered
   bool triggered_ = false;
 
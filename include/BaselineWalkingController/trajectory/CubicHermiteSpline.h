@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include <Eigen/Core>
 
 #include <mc_rtc/logging.h>
@@ -12,7 +14,7 @@ namespace BWC
     \tparam T function value type
 */
 template<class T>
-class CubicHermiteSpline : public PiecewiseFunc<T>
+class CubicHermiteSpline : public PiecewisePolynomial<T, 3>
 {
 public:
   /** \brief Constructor.
@@ -47,9 +49,9 @@ public:
   */
   void calcCoeff()
   {
-    this->funcs_.clear();
+    this->clearSegments();
 
-    // Set piecewise CubicPolynomial
+    // Set piecewise cubic polynomial
     size_t n = points_.size();
     if(n < 2)
     {
@@ -57,6 +59,7 @@ public:
     }
 
     {
+      this->setDomainLowerLimit(points_.begin()->first);
       auto pointIt = points_.begin();
       for(size_t k = 0; k < n - 1; k++, pointIt++)
       {
@@ -66,47 +69,18 @@ public:
         const T & vk1 = std::next(pointIt)->second.second;
         double deltaT = std::next(pointIt)->first - pointIt->first;
 
+        // The coefficients for the argument normalized by deltaT are scaled so that the segment can be evaluated with
+        // the argument offset by the start of segment
         // clang-format off
         std::array<T, 4> coeff = {
           pk,
-          deltaT * vk,
-          -3 * pk - 2 * deltaT * vk + 3 * pk1 - deltaT * vk1,
-          2 * pk + deltaT * vk - 2 * pk1 + deltaT * vk1};
+          vk,
+          (-3 * pk - 2 * deltaT * vk + 3 * pk1 - deltaT * vk1) / std::pow(deltaT, 2),
+          (2 * pk + deltaT * vk - 2 * pk1 + deltaT * vk1) / std::pow(deltaT, 3)};
         // clang-format on
-        std::shared_ptr<CubicPolynomial<T>> cubicFunc = std::make_shared<CubicPolynomial<T>>(coeff);
-        this->funcs_.emplace(std::next(pointIt)->first, cubicFunc);
+        this->appendSegment(std::next(pointIt)->first, coeff);
       }
     }
-
-    // Set tLowerLimit_
-    this->tLowerLimit_ = points_.begin()->first;
-  }
-
-  /** \brief Evaluate function value.
-      \param t arugment of function
-  */
-  virtual T operator()(double t) const override
-  {
-    this->checkArg(t);
-    auto funcIt = this->funcs_.lower_bound(t);
-
-    const auto & seg = argSegment(t);
-    double scaledT = (t - seg.first) / (seg.second - seg.first);
-    return (*(funcIt->second))(scaledT);
-  }
-
-  /** \brief Evaluate function derivative value.
-      \param t arugment of function
-      \param order derivative order
-  */
-  virtual T derivative(double t, int order = 1) const override
-  {
-    this->checkArg(t);
-    auto funcIt = this->funcs_.lower_bound(t);
-
-    const auto & seg = argSegment(t);
-    double scaledT = (t - seg.first) / (seg.second - seg.first);
-    return (funcIt->second)->derivative(scaledT, order) / (seg.second - seg.first);
   }
 
   /** \brief Overwrite the velocity with keeping the time and position for making cubic Hermite spline monotone.
@@ -225,20 +199,6 @@ public:
     }
   }
 
-protected:
-  /** \brief Get the piecewise segment.
-      \param t arugment of function
-  */
-  std::pair<double, double> argSegment(double t) const
-  {
-    auto funcIt = points_.lower_bound(t);
-    if(funcIt == points_.begin())
-    {
-      funcIt++;
-    }
-    return {std::prev(funcIt)->first, funcIt->first};
-  }
-
 protected:
   //! Dimension of value
   int dim_;
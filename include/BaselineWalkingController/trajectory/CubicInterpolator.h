@@ -1,8 +1,10 @@
 #pragma once
 
+#include <map>
+
 #include <SpaceVecAlg/SpaceVecAlg>
 
-#include <BaselineWalkingController/trajectory/CubicHermiteSpline.h>
+#include <BaselineWalkingController/trajectory/Func.h>
 
 namespace BWC
 {
@@ -171,68 +173,170 @@ inline sva::MotionVecd interpolateDerivative(const sva::PTransformd & start,
 template<class T, class U = T>
 class CubicInterpolator
 {
-protected:
-  //! 1D vector
-  using Vector1d = Eigen::Matrix<double, 1, 1>;
+public:
+  /** \brief Cursor to evaluate the interpolation at monotonically increasing times.
+
+      The cursor remembers the current segment, so advancing it costs amortized O(1). The cursor is invalidated when the
+      points are modified.
+  */
+  class Cursor
+  {
+  public:
+    /** \brief Constructor.
+        \param func cubic interpolator
+        \param t time
+    */
+    Cursor(const CubicInterpolator & func, double t) : func_(&func), t_(t), idx_(func.getIdx(t)) {}
+
+    /** \brief Move the cursor to the time.
+        \param t time
+    */
+    void advanceTo(double t)
+    {
+      func_->checkArg(t);
+      t_ = t;
+      idx_ = advanceSegmentIdx(func_->times_.data() + 1, func_->times_.size() - 1, idx_, t_);
+    }
+
+    /** \brief Get time. */
+    double t() const noexcept
+    {
+      return t_;
+    }
+
+    /** \brief Calculate interpolated value at the cursor. */
+    T value() const
+    {
+      return interpolate<T>(func_->values_[idx_], func_->values_[idx_ + 1], func_->calcSegmentRatio(idx_, t_, 0));
+    }
+
+    /** \brief Calculate the derivative of interpolated value at the cursor.
+        \param order derivative order
+    */
+    U derivative(int order = 1) const
+    {
+      return func_->calcSegmentRatio(idx_, t_, order)
+             * interpolateDerivative<T, U>(func_->values_[idx_], func_->values_[idx_ + 1],
+                                           func_->calcSegmentRatio(idx_, t_, 0), 1);
+    }
+
+    /** \brief Calculate interpolated value and its derivatives at the cursor.
+        \param order maximum derivative order (0, 1, or 2)
+    */
+    ValueWithDerivatives<T, U> evalAll(int order = 2) const
+    {
+      return func_->evalAll(idx_, t_, order);
+    }
+
+  protected:
+    //! Cubic interpolator
+    const CubicInterpolator * func_;
+
+    //! Time
+    double t_;
+
+    //! Index of the segment containing t_
+    size_t idx_;
+  };
 
 public:
   /** \brief Constructor.
       \param points times and values to be interpolated
   */
-  CubicInterpolator(const std::map<double, T> & points = {}) : points_(points)
+  CubicInterpolator(const std::map<double, T> & points = {})
   {
-    func_ = std::make_shared<CubicHermiteSpline<Vector1d>>(1, std::map<double, std::pair<Vector1d, Vector1d>>{});
+    times_.reserve(points.size());
+    values_.reserve(points.size());
+    for(const auto & point : points)
+    {
+      times_.push_back(point.first);
+      values_.push_back(point.second);
+    }
 
-    if(points_.size() >= 2)
+    if(times_.size() >= 2)
     {
       calcCoeff();
     }
   }
 
-  /** \brief Copy constructor. */
-  CubicInterpolator(const CubicInterpolator & inst)
+  /** \brief Clear points. */
+  void clearPoints()
+  {
+    times_.clear();
+    values_.clear();
+  }
+
+  /** \brief Remove points whose time is less than the specified time.
+      \param t time
+  */
+  void removePointsBefore(double t)
   {
-    points_ = inst.points_;
-    func_ = std::make_shared<CubicHermiteSpline<Vector1d>>(*inst.func_);
+    size_t num = std::lower_bound(times_.begin(), times_.end(), t) - times_.begin();
+    times_.erase(times_.begin(), times_.begin() + num);
+    values_.erase(values_.begin(), values_.begin() + num);
   }
 
-  /** \brief Clear points. */
-  void clearPoints()
+  /** \brief Remove points whose time is greater than the specified time.
+      \param t time
+  */
+  void removePointsAfter(double t)
   {
-    points_.clear();
+    size_t num = std::upper_bound(times_.begin(), times_.end(), t) - times_.begin();
+    times_.erase(times_.begin() + num, times_.end());
+    values_.erase(values_.begin() + num, values_.end());
   }
 
   /** \brief Add point.
       \param point time and value
 
+      The point is inserted so that the times are kept in ascending order. If the point with the same time already
+      exists, the new point is ignored.
+
       \note CubicInterpolator::calcCoeff should be called before calling CubicInterpolator::operator().
   */
   void appendPoint(const std::pair<double, T> & point)
   {
-    points_.insert(point);
-  }
+    // Points are usually added in chronological order, so check the end first
+    if(times_.empty() || times_.back() < point.first)
+    {
+      times_.push_back(point.first);
+      values_.push_back(point.second);
+      return;
+    }
 
-  /** \brief Calculate coefficients. */
-  void calcCoeff()
-  {
-    if(points_.size() < 2)
+    auto timeIt = std::lower_bound(times_.begin(), times_.end(), point.first);
+    if(*timeIt == point.first)
     {
-      mc_rtc::log::error_and_throw<std::out_of_range>("[CubicInterpolator] Number of points should be 2 or more: {}.",
-                                                      points_.size());
+      return;
     }
+    values_.insert(values_.begin() + (timeIt - times_.begin()), point.second);
+    times_.insert(timeIt, point.first);
+  }
 
-    func_->clearPoints();
+  /** \brief Overwrite the value of point.
+      \param idx index of point
+      \param value value
 
-    auto it = points_.begin();
-    for(size_t i = 0; i < points_.size(); i++)
+      Since nothing is precomputed from the values, the interpolation is updated without calling
+      CubicInterpolator::calcCoeff.
+  */
+  void setPointValue(size_t idx, const T & value)
+  {
+    values_.at(idx) = value;
+  }
+
+  /** \brief Calculate coefficients.
+
+      Since the velocity of each waypoint is zero, the interpolation ratio in each segment is given in closed form and
+      nothing needs to be precomputed. This only checks the number of points.
+  */
+  void calcCoeff()
+  {
+    if(times_.size() < 2)
     {
-      func_->appendPoint(std::make_pair(
-          it->first, std::make_pair((Vector1d() << static_cast<double>(i)).finished(), Vector1d::Zero())));
-      it++;
+      mc_rtc::log::error_and_throw<std::out_of_range>("[CubicInterpolator] Number of points should be 2 or more: {}.",
+                                                      times_.size());
     }
-
-    func_->setDomainLowerLimit(startTime());
-    func_->calcCoeff();
   }
 
   /** \brief Calculate interpolated value.
@@ -240,15 +344,8 @@ public:
   */
   T operator()(double t) const
   {
-    double ratio = getRatio(t);
-    size_t idx = getIdx(ratio);
-    if(!(idx + 1 <= points_.size() - 1))
-    {
-      mc_rtc::log::error_and_throw("[CubicInterpolator] Invalid idx {}. Should be {} <= idx <= {}", idx, 0,
-                                   points_.size() - 2);
-    }
-    return interpolate<T>(std::next(points_.begin(), idx)->second, std::next(points_.begin(), idx + 1)->second,
-                          std::min(std::max(ratio - static_cast<double>(idx), 0.0), 1.0));
+    size_t idx = getIdx(t);
+    return interpolate<T>(values_[idx], values_[idx + 1], calcSegmentRatio(idx, t, 0));
   }
 
   /** \brief Calculate the derivative of interpolated value.
@@ -259,64 +356,159 @@ public:
   */
   virtual U derivative(double t, int order = 1) const
   {
-    double ratio = getRatio(t);
-    size_t idx = getIdx(ratio);
-    return func_->derivative(t, order)[0]
-           * interpolateDerivative<T, U>(std::next(points_.begin(), idx)->second,
-                                         std::next(points_.begin(), idx + 1)->second,
-                                         std::min(std::max(ratio - static_cast<double>(idx), 0.0), 1.0), 1);
+    size_t idx = getIdx(t);
+    return calcSegmentRatio(idx, t, order)
+           * interpolateDerivative<T, U>(values_[idx], values_[idx + 1], calcSegmentRatio(idx, t, 0), 1);
+  }
+
+  /** \brief Calculate interpolated value and its derivatives.
+      \param t time
+      \param order maximum derivative order (0, 1, or 2)
+
+      The segment search, the interpolation ratio, and the derivative of interpolation (e.g., the rotation error for
+      rotations) are computed once and shared by the value and derivatives.
+  */
+  ValueWithDerivatives<T, U> evalAll(double t, int order = 2) const
+  {
+    return evalAll(getIdx(t), t, order);
   }
 
   /** \brief Get ratio of interpolation points.
       \param t time
+
+      The integer part represents the index of the segment and the fractional part represents the interpolation ratio
+      in the segment.
   */
   double getRatio(double t) const
   {
-    return (*func_)(t)[0];
+    size_t idx = getIdx(t);
+    return static_cast<double>(idx) + calcSegmentRatio(idx, t, 0);
   }
 
   /** \brief Get start time. */
   double startTime() const
   {
-    return points_.begin()->first;
+    return times_.front();
   }
 
   /** \brief Get end time. */
   double endTime() const
   {
-    return points_.rbegin()->first;
+    return times_.back();
+  }
+
+  /** \brief Get times of points in ascending order. */
+  const std::vector<double> & times() const
+  {
+    return times_;
   }
 
-  /** \brief Get points. */
-  const std::map<double, T> & points() const
+  /** \brief Get values of points corresponding to CubicInterpolator::times. */
+  const std::vector<T> & values() const
   {
-    return points_;
+    return values_;
+  }
+
+  /** \brief Get cursor to evaluate the interpolation at monotonically increasing times.
+      \param t initial time
+  */
+  Cursor cursor(double t) const
+  {
+    return Cursor(*this, t);
   }
 
 protected:
-  /** \brief Get index of interpolation points.
-      \param ratio Interpolation ratio
+  /** \brief Calculate interpolated value and its derivatives in the segment.
+      \param idx index of segment
+      \param t time
+      \param order maximum derivative order (0, 1, or 2)
   */
-  size_t getIdx(double ratio) const
+  ValueWithDerivatives<T, U> evalAll(size_t idx, double t, int order) const
   {
-    int idx = static_cast<int>(std::floor(ratio));
-    if(static_cast<size_t>(idx) == points_.size() - 1)
+    ValueWithDerivatives<T, U> ret;
+    double ratio = calcSegmentRatio(idx, t, 0);
+    ret.value = interpolate<T>(values_[idx], values_[idx + 1], ratio);
+    if(order >= 1)
+    {
+      U interpDeriv = interpolateDerivative<T, U>(values_[idx], values_[idx + 1], ratio, 1);
+      ret.vel = calcSegmentRatio(idx, t, 1) * interpDeriv;
+      if(order >= 2)
+      {
+        ret.accel = calcSegmentRatio(idx, t, 2) * interpDeriv;
+      }
+    }
+    return ret;
+  }
+
+  /** \brief Get index of the segment containing the time.
+      \param t time
+
+      The time on the boundary of segments belongs to the former segment.
+  */
+  size_t getIdx(double t) const
+  {
+    checkArg(t);
+    // The first element of times_ is skipped so that the search is done over the upper limits of segments
+    return findSegmentIdx(times_.data() + 1, times_.size() - 1, t);
+  }
+
+  /** \brief Check time.
+      \param t time
+  */
+  void checkArg(double t) const
+  {
+    if(times_.size() < 2)
+    {
+      mc_rtc::log::error_and_throw<std::out_of_range>("[CubicInterpolator] Number of points should be 2 or more: {}.",
+                                                      times_.size());
+    }
+    if(t < times_.front() || times_.back() < t)
+    {
+      mc_rtc::log::error_and_throw<std::out_of_range>(
+          "[CubicInterpolator] Argument is out of function range. it should be {} <= {} <= {}", times_.front(), t,
+          times_.back());
+    }
+  }
+
+  /** \brief Calculate the interpolation ratio in the segment or its derivative.
+      \param idx index of segment
+      \param t time
+      \param order derivative order
+
+      The ratio is the cubic Hermite polynomial with zero velocities at both ends, i.e., \f$3 s^2 - 2 s^3\f$ where
+      \f$s\f$ is the time normalized in the segment.
+  */
+  double calcSegmentRatio(size_t idx, double t, int order) const
+  {
+    double duration = times_[idx + 1] - times_[idx];
+    double s = std::min(std::max((t - times_[idx]) / duration, 0.0), 1.0);
+    if(order == 0)
+    {
+      return s * s * (3 - 2 * s);
+    }
+    else if(order == 1)
+    {
+      return 6 * s * (1 - s) / duration;
+    }
+    else if(order == 2)
+    {
+      return (6 - 12 * s) / (duration * duration);
+    }
+    else if(order == 3)
     {
-      idx--;
+      return -12 / (duration * duration * duration);
     }
-    if(idx < 0 || points_.size() - 2 < static_cast<size_t>(idx))
+    else
     {
-      mc_rtc::log::error_and_throw<std::out_of_range>("[CubicInterpolator] Index {} is out of range [{}, {}].", idx, 0,
-                                                      points_.size() - 2);
+      return 0.0;
     }
-    return static_cast<size_t>(idx);
   }
 
 protected:
-  //! Times and values to be interpolated
-  std::map<double, T> points_;
+  //! Times of points in ascending order
+  std::vector<double> times_;
 
-  //! Function to calculate the ratio of interpolation points
-  std::shared_ptr<CubicHermiteSpline<Vector1d>> func_;
+  //! Values of points corresponding to times_
+  std::vector<T> values_;
 };
 } // namespace BWC
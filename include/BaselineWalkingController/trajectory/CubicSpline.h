@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+
 #include <Eigen/Core>
 
 #include <mc_rtc/logging.h>
@@ -38,7 +40,7 @@ struct BoundaryConstraint
     \tparam T value type
 */
 template<class T>
-class CubicSpline : public PiecewiseFunc<T>
+class CubicSpline : public PiecewisePolynomial<T, 3>
 {
 public:
   /** \brief Constructor.
@@ -81,7 +83,7 @@ public:
   */
   void calcCoeff()
   {
-    this->funcs_.clear();
+    this->clearSegments();
 
     size_t n = points_.size();
     if(n < 2)
@@ -185,24 +187,20 @@ public:
       }
     }
 
-    // Set piecewise CubicPolynomial
+    // Set piecewise cubic polynomial
     {
+      this->setDomainLowerLimit(points_.begin()->first);
       auto pointIt = points_.begin();
       for(size_t k = 0; k < n - 1; k++, pointIt++)
       {
-        double t0 = pointIt->first;
         std::array<T, 4> coeff;
         for(size_t i = 0; i < coeffMatAll.size(); i++)
         {
           coeff[i] = coeffMatAll[i].col(k);
         }
-        std::shared_ptr<CubicPolynomial<T>> cubicFunc = std::make_shared<CubicPolynomial<T>>(coeff, t0);
-        this->funcs_.emplace(std::next(pointIt)->first, cubicFunc);
+        this->appendSegment(std::next(pointIt)->first, coeff);
       }
     }
-
-    // Set tLowerLimit_
-    this->tLowerLimit_ = points_.begin()->first;
   }
 
 protected:
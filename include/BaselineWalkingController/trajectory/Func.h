@@ -1,17 +1,79 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <functional>
 #include <limits>
-#include <map>
 #include <memory>
+#include <type_traits>
 #include <vector>
 
 #include <mc_rtc/logging.h>
 
 namespace BWC
 {
+/** \brief Get the index of the segment containing the argument.
+    \param upperLimits upper limits of domain of segments in ascending order
+    \param segNum number of segments (must be positive)
+    \param t arugment of function
+
+    Returns the index of the first segment whose upper limit is greater than or equal to t (i.e., the argument on the
+    boundary belongs to the former segment). The last index is returned if t exceeds all the upper limits. The binary
+    search is written without data-dependent branches so that it is not disturbed by branch misprediction.
+*/
+inline size_t findSegmentIdx(const double * upperLimits, size_t segNum, double t)
+{
+  const double * base = upperLimits;
+  size_t len = segNum;
+  while(len > 1)
+  {
+    size_t half = len / 2;
+    base = (base[half - 1] < t ? base + half : base);
+    len -= half;
+  }
+  return static_cast<size_t>(base - upperLimits);
+}
+
+/** \brief Advance the index of the segment containing the argument.
+    \param upperLimits upper limits of domain of segments in ascending order
+    \param segNum number of segments (must be positive)
+    \param segIdx index of the segment containing the previous argument
+    \param t arugment of function
+
+    The segments are searched linearly from segIdx, so the total cost is proportional to the number of passed segments
+    when the argument increases monotonically. If the argument decreases before the segment, the binary search is used.
+*/
+inline size_t advanceSegmentIdx(const double * upperLimits, size_t segNum, size_t segIdx, double t)
+{
+  if(segIdx > 0 && t <= upperLimits[segIdx - 1])
+  {
+    return findSegmentIdx(upperLimits, segNum, t);
+  }
+  while(segIdx + 1 < segNum && upperLimits[segIdx] < t)
+  {
+    segIdx++;
+  }
+  return segIdx;
+}
+
+/** \brief Function value with its derivatives.
+    \tparam T value type
+    \tparam U derivative type
+*/
+template<class T, class U = T>
+struct ValueWithDerivatives
+{
+  //! Value
+  T value;
+
+  //! First-order derivative (valid if the requested order is 1 or more)
+  U vel;
+
+  //! Second-order derivative (valid if the requested order is 2)
+  U accel;
+};
+
 /** \brief Mathematical function.
     \tparam T function value type
 */
@@ -33,6 +95,27 @@ public:
   */
   virtual T derivative(double t, int order = 1) const = 0;
 
+  /** \brief Evaluate function value and derivative values.
+      \param t arugment of function
+      \param order maximum derivative order (0, 1, or 2)
+
+      Inherited classes override this to share the segment search and intermediate terms.
+  */
+  virtual ValueWithDerivatives<T> evalAll(double t, int order = 2) const
+  {
+    ValueWithDerivatives<T> ret;
+    ret.value = (*this)(t);
+    if(order >= 1)
+    {
+      ret.vel = derivative(t, 1);
+    }
+    if(order >= 2)
+    {
+      ret.accel = derivative(t, 2);
+    }
+    return ret;
+  }
+
   /** \brief Get lower limit of domain. */
   virtual double domainLowerLimit() const
   {
@@ -52,6 +135,74 @@ public:
 template<class T>
 class PiecewiseFunc : public Func<T>
 {
+public:
+  /** \brief Cursor to evaluate the function at monotonically increasing arguments.
+
+      The cursor remembers the current segment, so advancing it costs amortized O(1). The cursor is invalidated when the
+      functions are modified.
+  */
+  class Cursor
+  {
+  public:
+    /** \brief Constructor.
+        \param func piecewise function
+        \param t arugment of function
+    */
+    Cursor(const PiecewiseFunc & func, double t) : func_(&func), t_(t)
+    {
+      func_->checkArg(t_);
+      segIdx_ = findSegmentIdx(func_->tUpperLimits_.data(), func_->tUpperLimits_.size(), t_);
+    }
+
+    /** \brief Move the cursor to the argument.
+        \param t arugment of function
+    */
+    void advanceTo(double t)
+    {
+      func_->checkArg(t);
+      t_ = t;
+      segIdx_ = advanceSegmentIdx(func_->tUpperLimits_.data(), func_->tUpperLimits_.size(), segIdx_, t_);
+    }
+
+    /** \brief Get argument of function. */
+    double t() const noexcept
+    {
+      return t_;
+    }
+
+    /** \brief Evaluate function value at the cursor. */
+    T value() const
+    {
+      return (*func_->funcs_[segIdx_])(t_);
+    }
+
+    /** \brief Evaluate function derivative value at the cursor.
+        \param order derivative order
+    */
+    T derivative(int order = 1) const
+    {
+      return func_->funcs_[segIdx_]->derivative(t_, order);
+    }
+
+    /** \brief Evaluate function value and derivative values at the cursor.
+        \param order maximum derivative order (0, 1, or 2)
+    */
+    ValueWithDerivatives<T> evalAll(int order = 2) const
+    {
+      return func_->funcs_[segIdx_]->evalAll(t_, order);
+    }
+
+  protected:
+    //! Piecewise function
+    const PiecewiseFunc * func_;
+
+    //! Argument of function
+    double t_;
+
+    //! Index of the segment containing t_
+    size_t segIdx_;
+  };
+
 public:
   /** \brief Constructor. */
   PiecewiseFunc() {}
@@ -62,8 +213,7 @@ public:
   virtual T operator()(double t) const override
   {
     checkArg(t);
-    auto funcIt = funcs_.lower_bound(t);
-    return (*(funcIt->second))(t);
+    return (*funcs_[findSegmentIdx(tUpperLimits_.data(), tUpperLimits_.size(), t)])(t);
   }
 
   /** \brief Evaluate function derivative value.
@@ -73,8 +223,17 @@ public:
   virtual T derivative(double t, int order = 1) const override
   {
     checkArg(t);
-    auto funcIt = funcs_.lower_bound(t);
-    return (funcIt->second)->derivative(t, order);
+    return funcs_[findSegmentIdx(tUpperLimits_.data(), tUpperLimits_.size(), t)]->derivative(t, order);
+  }
+
+  /** \brief Evaluate function value and derivative values.
+      \param t arugment of function
+      \param order maximum derivative order (0, 1, or 2)
+  */
+  virtual ValueWithDerivatives<T> evalAll(double t, int order = 2) const override
+  {
+    checkArg(t);
+    return funcs_[findSegmentIdx(tUpperLimits_.data(), tUpperLimits_.size(), t)]->evalAll(t, order);
   }
 
   /** \brief Get lower limit of domain. */
@@ -90,12 +249,13 @@ public:
     {
       return std::numeric_limits<double>::max();
     }
-    return funcs_.rbegin()->first;
+    return tUpperLimits_.back();
   }
 
   /** \brief Clear function. */
   void clearFuncs()
   {
+    tUpperLimits_.clear();
     funcs_.clear();
     tLowerLimit_ = std::numeric_limits<double>::lowest();
   }
@@ -103,10 +263,19 @@ public:
   /** \brief Add function.
       \param t upper bound of domain
       \param func function
+
+      The function is inserted so that the upper bounds are kept in ascending order. If the function with the same upper
+      bound already exists, the new function is ignored.
   */
   void appendFunc(double t, std::shared_ptr<Func<T>> func)
   {
-    funcs_.insert(std::pair<double, std::shared_ptr<Func<T>>>(t, func));
+    auto tIt = std::lower_bound(tUpperLimits_.begin(), tUpperLimits_.end(), t);
+    if(tIt != tUpperLimits_.end() && *tIt == t)
+    {
+      return;
+    }
+    funcs_.insert(funcs_.begin() + (tIt - tUpperLimits_.begin()), func);
+    tUpperLimits_.insert(tIt, t);
   }
 
   /** \brief Set lower limit of domain
@@ -117,22 +286,37 @@ public:
     tLowerLimit_ = t;
   }
 
+  /** \brief Get cursor to evaluate the function at monotonically increasing arguments.
+      \param t initial arugment of function
+  */
+  Cursor cursor(double t) const
+  {
+    return Cursor(*this, t);
+  }
+
 protected:
   /** \brief Check argument of function.
       \param t arugment of function
   */
   void checkArg(double t) const
   {
-    if(t < tLowerLimit_ || funcs_.rbegin()->first < t)
+    if(funcs_.empty())
+    {
+      mc_rtc::log::error_and_throw("[PiecewiseFunc] Function is empty.");
+    }
+    if(t < tLowerLimit_ || tUpperLimits_.back() < t)
     {
       mc_rtc::log::error_and_throw("[PiecewiseFunc] Argument is out of function range. it should be {} <= {} <= {}",
-                                   tLowerLimit_, t, funcs_.rbegin()->first);
+                                   tLowerLimit_, t, tUpperLimits_.back());
     }
   }
 
 protected:
-  //! Map of upper bound of domain and function
-  std::map<double, std::shared_ptr<Func<T>>> funcs_;
+  //! Upper bounds of domain in ascending order
+  std::vector<double> tUpperLimits_;
+
+  //! Functions corresponding to tUpperLimits_
+  std::vector<std::shared_ptr<Func<T>>> funcs_;
 
   //! Lower limit of domain of this function
   double tLowerLimit_ = std::numeric_limits<double>::lowest();
@@ -163,12 +347,7 @@ public:
   */
   virtual T operator()(double t) const override
   {
-    T ret = coeff_[0];
-    for(int i = 0; i < Order; i++)
-    {
-      ret += coeff_[i + 1] * std::pow(t - t0_, i + 1);
-    }
-    return ret;
+    return eval(coeff_, t - t0_);
   }
 
   /** \brief Evaluate function derivative value.
@@ -177,33 +356,159 @@ public:
   */
   virtual T derivative(double t, int derivativeOrder = 1) const override
   {
-    if(derivativeOrder > Order)
+    return evalDerivative(coeff_, t - t0_, derivativeOrder);
+  }
+
+  /** \brief Evaluate function value and derivative values.
+      \param t arugment of function
+      \param order maximum derivative order (0, 1, or 2)
+  */
+  virtual ValueWithDerivatives<T> evalAll(double t, int order = 2) const override
+  {
+    return evalWithDerivatives(coeff_, t - t0_, order);
+  }
+
+  /** \brief Evaluate polynomial value from coefficients.
+      \param coeff coefficients of polynomial (from low order (i.e., constant term) to high order)
+      \param dt arugment of function minus offset
+  */
+  static T eval(const std::array<T, Order + 1> & coeff, double dt)
+  {
+    return evalDerivative<0>(coeff, dt);
+  }
+
+  /** \brief Evaluate polynomial derivative value from coefficients.
+      \tparam DerivativeOrder derivative order
+      \param coeff coefficients of polynomial (from low order (i.e., constant term) to high order)
+      \param dt arugment of function minus offset
+
+      The polynomial is evaluated in Horner form with the derivative factors in derivativeFactorTable.
+  */
+  template<int DerivativeOrder>
+  static T evalDerivative(const std::array<T, Order + 1> & coeff, double dt)
+  {
+    if constexpr(DerivativeOrder > Order)
     {
-      T ret;
-      // \todo Rows and cols are necessary for matrix with dynamic size.
-      ret.setZero();
+      return zero(coeff);
+    }
+    else
+    {
+      constexpr const std::array<double, Order + 1> & factors = derivativeFactorTable[DerivativeOrder];
+      T ret = factors[Order] * coeff[Order];
+      for(int i = Order - 1; i >= DerivativeOrder; i--)
+      {
+        ret = ret * dt + factors[i] * coeff[i];
+      }
       return ret;
     }
+  }
+
+  /** \brief Evaluate polynomial derivative value from coefficients.
+      \param coeff coefficients of polynomial (from low order (i.e., constant term) to high order)
+      \param dt arugment of function minus offset
+      \param derivativeOrder derivative order
+  */
+  static T evalDerivative(const std::array<T, Order + 1> & coeff, double dt, int derivativeOrder = 1)
+  {
+    if(derivativeOrder < 0)
+    {
+      mc_rtc::log::error_and_throw("[Polynomial] Derivative order must be non-negative: {}", derivativeOrder);
+    }
 
-    T ret = coeff_[derivativeOrder];
-    for(int j = 0; j < derivativeOrder - 1; j++)
+    switch(derivativeOrder)
     {
-      ret *= (derivativeOrder - j);
+      case 0:
+        return evalDerivative<0>(coeff, dt);
+      case 1:
+        return evalDerivative<1>(coeff, dt);
+      case 2:
+        return evalDerivative<2>(coeff, dt);
+      case 3:
+        return evalDerivative<3>(coeff, dt);
+      default:
+        break;
     }
 
-    for(int i = 0; i < Order - derivativeOrder; i++)
+    if(derivativeOrder > Order)
+    {
+      return zero(coeff);
+    }
+    const std::array<double, Order + 1> & factors = derivativeFactorTable[derivativeOrder];
+    T ret = factors[Order] * coeff[Order];
+    for(int i = Order - 1; i >= derivativeOrder; i--)
     {
-      T term = coeff_[i + 1 + derivativeOrder] * std::pow(t - t0_, i + 1);
-      for(int j = 0; j < derivativeOrder; j++)
+      ret = ret * dt + factors[i] * coeff[i];
+    }
+    return ret;
+  }
+
+  /** \brief Evaluate polynomial value and derivative values from coefficients.
+      \param coeff coefficients of polynomial (from low order (i.e., constant term) to high order)
+      \param dt arugment of function minus offset
+      \param order maximum derivative order (0, 1, or 2)
+  */
+  static ValueWithDerivatives<T> evalWithDerivatives(const std::array<T, Order + 1> & coeff, double dt, int order = 2)
+  {
+    ValueWithDerivatives<T> ret;
+    ret.value = evalDerivative<0>(coeff, dt);
+    if(order >= 1)
+    {
+      ret.vel = evalDerivative<1>(coeff, dt);
+    }
+    if(order >= 2)
+    {
+      ret.accel = evalDerivative<2>(coeff, dt);
+    }
+    return ret;
+  }
+
+protected:
+  /** \brief Make the table of derivative factors.
+
+      The element (k, i) is the factor of the i-th order coefficient in the k-th order derivative, i.e., i! / (i - k)!
+      for i >= k and zero otherwise.
+  */
+  static constexpr std::array<std::array<double, Order + 1>, Order + 1> makeDerivativeFactorTable()
+  {
+    std::array<std::array<double, Order + 1>, Order + 1> table{};
+    for(int k = 0; k <= Order; k++)
+    {
+      for(int i = k; i <= Order; i++)
       {
-        term *= (i + 1 + derivativeOrder - j);
+        double factor = 1.0;
+        for(int j = 0; j < k; j++)
+        {
+          factor *= static_cast<double>(i - j);
+        }
+        table[k][i] = factor;
       }
-      ret += term;
     }
+    return table;
+  }
 
-    return ret;
+  /** \brief Get zero with the same size as the coefficient.
+      \param coeff coefficients of polynomial
+  */
+  static T zero(const std::array<T, Order + 1> & coeff)
+  {
+    if constexpr(std::is_arithmetic_v<T>)
+    {
+      return T(0);
+    }
+    else
+    {
+      // Copy the coefficient so that the size of a matrix with dynamic size is retained
+      T ret = coeff[0];
+      ret.setZero();
+      return ret;
+    }
   }
 
+protected:
+  //! Table of derivative factors (see makeDerivativeFactorTable)
+  static constexpr std::array<std::array<double, Order + 1>, Order + 1> derivativeFactorTable =
+      makeDerivativeFactorTable();
+
 protected:
   //! Coefficients from low order (i.e., constant term) to high order
   std::array<T, Order + 1> coeff_;
@@ -212,6 +517,287 @@ protected:
   double t0_;
 };
 
+/** \brief Piecewise polynomial function.
+    \tparam T function value type
+    \tparam Order order of polynomial function
+
+    Unlike PiecewiseFunc, the breakpoints and the polynomial coefficients of all segments are stored in contiguous
+    arrays, and the segments are evaluated without virtual function calls. The coefficients of each segment are
+    represented with the argument offset by the start of the segment.
+*/
+template<class T, int Order>
+class PiecewisePolynomial : public Func<T>
+{
+public:
+  //! Coefficients of a segment from low order (i.e., constant term) to high order
+  using Coeff = std::array<T, Order + 1>;
+
+  /** \brief Cursor to evaluate the function at monotonically increasing arguments.
+
+      The cursor remembers the current segment, so advancing it costs amortized O(1). The cursor is invalidated when the
+      segments are modified.
+  */
+  class Cursor
+  {
+  public:
+    /** \brief Constructor.
+        \param func piecewise polynomial
+        \param t arugment of function
+    */
+    Cursor(const PiecewisePolynomial & func, double t) : func_(&func), t_(t), segIdx_(func.segmentIdx(t)) {}
+
+    /** \brief Move the cursor to the argument.
+        \param t arugment of function
+    */
+    void advanceTo(double t)
+    {
+      func_->checkArg(t);
+      t_ = t;
+      segIdx_ = advanceSegmentIdx(func_->breakpoints_.data() + 1, func_->coeffs_.size(), segIdx_, t_);
+    }
+
+    /** \brief Get argument of function. */
+    double t() const noexcept
+    {
+      return t_;
+    }
+
+    /** \brief Get index of the segment containing the argument. */
+    size_t segmentIdx() const noexcept
+    {
+      return segIdx_;
+    }
+
+    /** \brief Evaluate function value at the cursor. */
+    T value() const
+    {
+      return Polynomial<T, Order>::eval(func_->coeffs_[segIdx_], t_ - func_->breakpoints_[segIdx_]);
+    }
+
+    /** \brief Evaluate function derivative value at the cursor.
+        \param order derivative order
+    */
+    T derivative(int order = 1) const
+    {
+      return Polynomial<T, Order>::evalDerivative(func_->coeffs_[segIdx_], t_ - func_->breakpoints_[segIdx_], order);
+    }
+
+    /** \brief Evaluate function value and derivative values at the cursor.
+        \param order maximum derivative order (0, 1, or 2)
+    */
+    ValueWithDerivatives<T> evalAll(int order = 2) const
+    {
+      return Polynomial<T, Order>::evalWithDerivatives(func_->coeffs_[segIdx_], t_ - func_->breakpoints_[segIdx_],
+                                                       order);
+    }
+
+  protected:
+    //! Piecewise polynomial
+    const PiecewisePolynomial * func_;
+
+    //! Argument of function
+    double t_;
+
+    //! Index of the segment containing t_
+    size_t segIdx_;
+  };
+
+public:
+  /** \brief Constructor. */
+  PiecewisePolynomial() {}
+
+  /** \brief Evaluate function value.
+      \param t arugment of function
+  */
+  virtual T operator()(double t) const override
+  {
+    size_t segIdx = segmentIdx(t);
+    return Polynomial<T, Order>::eval(coeffs_[segIdx], t - breakpoints_[segIdx]);
+  }
+
+  /** \brief Evaluate function derivative value.
+      \param t arugment of function
+      \param order derivative order
+  */
+  virtual T derivative(double t, int order = 1) const override
+  {
+    size_t segIdx = segmentIdx(t);
+    return Polynomial<T, Order>::evalDerivative(coeffs_[segIdx], t - breakpoints_[segIdx], order);
+  }
+
+  /** \brief Evaluate function value and derivative values.
+      \param t arugment of function
+      \param order maximum derivative order (0, 1, or 2)
+  */
+  virtual ValueWithDerivatives<T> evalAll(double t, int order = 2) const override
+  {
+    size_t segIdx = segmentIdx(t);
+    return Polynomial<T, Order>::evalWithDerivatives(coeffs_[segIdx], t - breakpoints_[segIdx], order);
+  }
+
+  /** \brief Get lower limit of domain. */
+  virtual double domainLowerLimit() const override
+  {
+    if(breakpoints_.empty())
+    {
+      return std::numeric_limits<double>::lowest();
+    }
+    return breakpoints_.front();
+  }
+
+  /** \brief Get upper limit of domain. */
+  virtual double domainUpperLimit() const override
+  {
+    if(coeffs_.empty())
+    {
+      return std::numeric_limits<double>::max();
+    }
+    return breakpoints_.back();
+  }
+
+  /** \brief Clear segments. */
+  void clearSegments()
+  {
+    breakpoints_.clear();
+    coeffs_.clear();
+  }
+
+  /** \brief Set lower limit of domain.
+      \param t lower limit of domain
+
+      This must be called before appending the first segment by PiecewisePolynomial::appendSegment.
+  */
+  void setDomainLowerLimit(double t)
+  {
+    if(!coeffs_.empty())
+    {
+      mc_rtc::log::error_and_throw("[PiecewisePolynomial] Domain lower limit cannot be set after adding segments.");
+    }
+    breakpoints_.assign(1, t);
+  }
+
+  /** \brief Add segment to the end.
+      \param t upper limit of domain of segment
+      \param coeff coefficients of segment with the argument offset by the start of segment
+  */
+  void appendSegment(double t, const Coeff & coeff)
+  {
+    if(breakpoints_.empty())
+    {
+      mc_rtc::log::error_and_throw("[PiecewisePolynomial] Domain lower limit should be set before adding segments.");
+    }
+    if(t < breakpoints_.back())
+    {
+      mc_rtc::log::error_and_throw("[PiecewisePolynomial] Segments should be added in ascending order: {} < {}", t,
+                                   breakpoints_.back());
+    }
+    breakpoints_.push_back(t);
+    coeffs_.push_back(coeff);
+  }
+
+  /** \brief Add all segments of another piecewise polynomial to the end.
+      \param func piecewise polynomial whose domain starts from the end of this function
+  */
+  void appendSegments(const PiecewisePolynomial & func)
+  {
+    if(func.coeffs_.empty())
+    {
+      return;
+    }
+    if(breakpoints_.empty())
+    {
+      breakpoints_.push_back(func.breakpoints_.front());
+    }
+    for(size_t i = 0; i < func.coeffs_.size(); i++)
+    {
+      appendSegment(func.breakpoints_[i + 1], func.coeffs_[i]);
+    }
+  }
+
+  /** \brief Add another piecewise polynomial with the same breakpoints whose coefficients are scaled elementwise.
+      \param func piecewise polynomial with the same breakpoints
+      \param scale elementwise scale of the coefficients of func
+
+      Since each coefficient is modified in place, this does not allocate.
+  */
+  void addScaledSegments(const PiecewisePolynomial & func, const T & scale)
+  {
+    if(func.coeffs_.size() != coeffs_.size())
+    {
+      mc_rtc::log::error_and_throw("[PiecewisePolynomial] Number of segments is not consistent: {} != {}",
+                                   func.coeffs_.size(), coeffs_.size());
+    }
+    for(size_t i = 0; i < coeffs_.size(); i++)
+    {
+      for(int j = 0; j <= Order; j++)
+      {
+        coeffs_[i][j] += func.coeffs_[i][j].cwiseProduct(scale);
+      }
+    }
+  }
+
+  /** \brief Get number of segments. */
+  size_t segmentNum() const noexcept
+  {
+    return coeffs_.size();
+  }
+
+  /** \brief Get breakpoints (i.e., the lower limit of domain followed by the upper limits of segments). */
+  const std::vector<double> & breakpoints() const noexcept
+  {
+    return breakpoints_;
+  }
+
+  /** \brief Get coefficients of segments. */
+  const std::vector<Coeff> & coeffs() const noexcept
+  {
+    return coeffs_;
+  }
+
+  /** \brief Get cursor to evaluate the function at monotonically increasing arguments.
+      \param t initial arugment of function
+  */
+  Cursor cursor(double t) const
+  {
+    return Cursor(*this, t);
+  }
+
+protected:
+  /** \brief Get the index of the segment containing the argument.
+      \param t arugment of function
+  */
+  size_t segmentIdx(double t) const
+  {
+    checkArg(t);
+    // The first element of breakpoints_ is skipped so that the search is done over the upper limits
+    return findSegmentIdx(breakpoints_.data() + 1, coeffs_.size(), t);
+  }
+
+  /** \brief Check argument of function.
+      \param t arugment of function
+  */
+  void checkArg(double t) const
+  {
+    if(coeffs_.empty())
+    {
+      mc_rtc::log::error_and_throw("[PiecewisePolynomial] Function is empty.");
+    }
+    if(t < breakpoints_.front() || breakpoints_.back() < t)
+    {
+      mc_rtc::log::error_and_throw(
+          "[PiecewisePolynomial] Argument is out of function range. it should be {} <= {} <= {}", breakpoints_.front(),
+          t, breakpoints_.back());
+    }
+  }
+
+protected:
+  //! Lower limit of domain followed by upper limits of segments in ascending order
+  std::vector<double> breakpoints_;
+
+  //! Coefficients of segments
+  std::vector<Coeff> coeffs_;
+};
+
 /** \brief Constant function.
     \tparam T function value type
 */
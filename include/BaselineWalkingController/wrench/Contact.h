@@ -22,6 +22,12 @@ public:
   /** \brief Calculate ridge vector list in global coordinates. */
   std::vector<Eigen::Vector3d> calcGlobalRidgeList(const Eigen::Matrix3d & rot) const;
 
+  /** \brief Calculate ridge vector list in global coordinates without allocation.
+      \param rot rotation from local to global coordinates
+      \param globalRidgeList ridge vector list in global coordinates (must have ridgeNum() elements)
+   */
+  void calcGlobalRidgeList(const Eigen::Matrix3d & rot, std::vector<Eigen::Vector3d> & globalRidgeList) const;
+
   /** \brief Number of ridges. */
   inline int ridgeNum() const
   {
@@ -64,11 +70,21 @@ public:
       \param fricCoeff friction coefficient
       \param localVertexList vertices of surface in local coordinates
       \param pose pose of contact
+      \param ridgeNum number of ridges of friction pyramid
    */
   Contact(const std::string & name,
           double fricCoeff,
           const std::vector<Eigen::Vector3d> & localVertexList,
-          const sva::PTransformd & pose);
+          const sva::PTransformd & pose,
+          int ridgeNum = 4);
+
+  /** \brief Update pose of contact.
+      \param pose pose of contact
+
+      The local vertices and the local ridges of the friction pyramid are kept, and the grasp matrix and the vertex list
+      are overwritten in place. Therefore, no heap allocation occurs.
+   */
+  void updatePose(const sva::PTransformd & pose);
 
   /** \brief Calculate wrench.
       \param wrenchRatio wrench ratio of each ridge
@@ -78,6 +94,24 @@ public:
   sva::ForceVecd calcWrench(const Eigen::VectorXd & wrenchRatio,
                             const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
 
+  /** \brief Get friction coefficient. */
+  inline double fricCoeff() const noexcept
+  {
+    return fricCoeff_;
+  }
+
+  /** \brief Get vertices of surface in local coordinates. */
+  inline const std::vector<Eigen::Vector3d> & localVertexList() const noexcept
+  {
+    return localVertexList_;
+  }
+
+  /** \brief Get pose of contact. */
+  inline const sva::PTransformd & pose() const noexcept
+  {
+    return pose_;
+  }
+
 public:
   //! Name of contact
   std::string name_;
@@ -87,5 +121,18 @@ public:
 
   //! List of vertex with ridges
   std::vector<VertexWithRidge> vertexWithRidgeList_;
+
+protected:
+  //! Friction coefficient
+  double fricCoeff_;
+
+  //! Friction pyramid
+  FrictionPyramid fricPyramid_;
+
+  //! Vertices of surface in local coordinates
+  std::vector<Eigen::Vector3d> localVertexList_;
+
+  //! Pose of contact
+  sva::PTransformd pose_ = sva::PTransformd::Identity();
 };
 } // namespace BWC
@@ -12,6 +12,16 @@ class Contact;
 class WrenchDistribution
 {
 public:
+  /** \brief Solver mode. */
+  enum class SolverMode
+  {
+    //! Dense QP of the ridge forces
+    Qp = 0,
+
+    //! Primal active set method in the wrench space
+    ActiveSet
+  };
+
   /** \brief Configuration. */
   struct Configuration
   {
@@ -24,12 +34,53 @@ public:
     //! Min/max ridge force
     std::pair<double, double> ridgeForceMinMax = std::make_pair(3, 1000); // [N]
 
+    /** \brief Whether to enable warm start
+
+        If true, the active set of the previous result is reused when the contact set is unchanged. The QP solver is
+        called only when the solution of the reduced problem does not satisfy the optimality conditions.
+    */
+    bool enableWarmStart = false;
+
+    /** \brief Solver mode ("Qp" or "ActiveSet")
+
+        "Qp" solves the dense QP of the ridge forces with the solver specified by qpSolverType. "ActiveSet" solves the
+        box-constrained least squares problem with the primal active set method, where the subproblem of the free
+        variables is reduced to a 6x6 linear equation in the wrench space by exploiting the rank of the grasp matrix.
+        If the active set method does not converge, the QP solver is used as a fallback.
+    */
+    std::string solverMode = "Qp";
+
+    //! Solver mode parsed from solverMode
+    SolverMode solverModeType = SolverMode::Qp;
+
+    /** \brief QP solver type ("Any" for the default solver of QpSolverCollection)
+
+        The QP solver is used in the "Qp" solver mode, and when the warm start or the active set method fails. Since
+        QpSolverCollection does not accept an initial guess, the warm start by enableWarmStart is done independently of
+        the QP solver. Solvers that reuse their internal workspace between calls with the same dimensions (e.g., "OSQP"
+        or "qpOASES") can be specified to further reduce the computation duration of the QP solver itself.
+    */
+    std::string qpSolverType = "Any";
+
     /** \brief Load mc_rtc configuration.
         \param mcRtcConfig mc_rtc configuration
     */
     void load(const mc_rtc::Configuration & mcRtcConfig);
   };
 
+  /** \brief Statistics of the last solve. */
+  struct SolveStat
+  {
+    //! Whether the result was obtained by warm start
+    bool warmStarted = false;
+
+    //! Number of iterations of the active set method (zero if not used)
+    int iterNum = 0;
+
+    //! Computation duration [ms]
+    double duration = 0;
+  };
+
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
@@ -37,9 +88,18 @@ public:
       \param contactList list of contact constraint
       \param mcRtcConfig mc_rtc configuration
    */
-  WrenchDistribution(const std::unordered_map<Foot, std::shared_ptr<Contact>> & contactList,
+  WrenchDistribution(const FootMap<std::shared_ptr<Contact>> & contactList,
                      const mc_rtc::Configuration & mcRtcConfig = {});
 
+  /** \brief Set contact list.
+      \param contactList list of contact constraint
+
+      The set of feet in contactList must be the same as the one given in the constructor. The QP solver and the QP
+      coefficients are retained, so this should be used instead of reconstructing the instance when only the contact
+      poses change.
+   */
+  void setContactList(const FootMap<std::shared_ptr<Contact>> & contactList);
+
   /** \brief Run wrench distribution calculation.
       \param desiredTotalWrench total wrench
       \param momentOrigin moment origin
@@ -52,8 +112,7 @@ public:
       \param momentOrigin moment origin
       \returns contact wrench list
    */
-  std::unordered_map<Foot, sva::ForceVecd> calcWrenchList(
-      const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
+  FootMap<sva::ForceVecd> calcWrenchList(const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
 
   /** \brief Const accessor to the configuration. */
   inline const Configuration & config() const noexcept
@@ -61,9 +120,48 @@ public:
     return config_;
   }
 
+  /** \brief Const accessor to the statistics of the last solve. */
+  inline const SolveStat & solveStat() const noexcept
+  {
+    return solveStat_;
+  }
+
+protected:
+  /** \brief Set the objective of QP.
+      \tparam VarDim dimension of QP variables (Eigen::Dynamic for an arbitrary dimension)
+
+      For the standard dimensions (see footVarDim), fixed-size matrices are used so that the compiler can unroll and
+      vectorize the product of grasp matrices.
+   */
+  template<int VarDim>
+  void setQpObjective();
+
+  /** \brief Solve QP by reusing the active set of the previous result.
+      \returns whether the solution satisfying the optimality conditions is obtained
+
+      The variables at the bounds in the previous result are fixed to the bounds, and the equality-constrained problem
+      of the remaining variables is solved. If the solution is within the bounds and the gradient of the fixed variables
+      points outward, it is the optimal solution of the original QP.
+   */
+  bool solveWithWarmStart();
+
+  /** \brief Solve the box-constrained least squares problem with the primal active set method.
+      \param warmStart whether to start from the active set of the previous result
+      \returns whether the method converged
+
+      The optimal free variables for the fixed bounded variables are obtained as \f$x_F = G_F^T S (S G_F G_F^T S + r
+      I)^{-1} S b\f$, where \f$S\f$ is the square root of the wrench weight, \f$r\f$ is the regularization weight,
+      and \f$b\f$ is the desired wrench minus the wrench of the bounded variables. Therefore, only a 6x6 matrix is
+      decomposed in each iteration regardless of the number of variables.
+   */
+  bool solveActiveSet(bool warmStart);
+
 public:
+  //! Dimension of QP variables for a foot contact with 4 vertices and 4 ridges
+  static constexpr int footVarDim = 16;
+
   //! List of contact constraint
-  std::unordered_map<Foot, std::shared_ptr<Contact>> contactList_;
+  FootMap<std::shared_ptr<Contact>> contactList_;
 
   //! Result wrench ratio
   Eigen::VectorXd resultWrenchRatio_;
@@ -83,5 +181,32 @@ public:
 protected:
   //! Configuration
   Configuration config_;
+
+  //! Total grasp matrix (moment rows are represented around the moment origin)
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat_;
+
+  //! Total grasp matrix weighted by the wrench weight (used only for non-standard dimensions)
+  Eigen::Matrix<double, 6, Eigen::Dynamic> weightedGraspMat_;
+
+  //! Statistics of the last solve
+  SolveStat solveStat_;
+
+  //! Whether the previous result can be used for warm start
+  bool warmStartAvailable_ = false;
+
+  //! Buffers for warm start
+  //! @{
+  Eigen::VectorXd warmStartWrenchRatio_;
+  Eigen::VectorXi freeIdxList_;
+  Eigen::MatrixXd reducedObjMat_;
+  Eigen::VectorXd reducedObjVec_;
+  Eigen::VectorXd objGrad_;
+  //! @}
+
+  //! Bound state of each variable in the active set method (-1: lower bound, 0: free, 1: upper bound)
+  Eigen::VectorXi boundStateList_;
+
+  //! Candidate of the wrench ratio in the active set method
+  Eigen::VectorXd candidateWrenchRatio_;
 };
 } // namespace BWC
@@ -16,6 +16,35 @@
 
 using namespace BWC;
 
+namespace
+{
+std::shared_ptr<CentroidalManager> makeCentroidalManager(BaselineWalkingController * ctlPtr,
+                                                         const std::string & method,
+                                                         const mc_rtc::Configuration & mcRtcConfig)
+{
+  if(method == "PreviewControlZmp")
+  {
+    return std::make_shared<CentroidalManagerPreviewControlZmp>(ctlPtr, mcRtcConfig);
+  }
+  else if(method == "DdpZmp")
+  {
+    return std::make_shared<CentroidalManagerDdpZmp>(ctlPtr, mcRtcConfig);
+  }
+  else if(method == "FootGuidedControl")
+  {
+    return std::make_shared<CentroidalManagerFootGuidedControl>(ctlPtr, mcRtcConfig);
+  }
+  else if(method == "IntrinsicallyStableMpc")
+  {
+    return std::make_shared<CentroidalManagerIntrinsicallyStableMpc>(ctlPtr, mcRtcConfig);
+  }
+  else
+  {
+    mc_rtc::log::error_and_throw("[BaselineWalkingController] Invalid centroidalManagerMethod: {}.", method);
+  }
+}
+} // namespace
+
 BaselineWalkingController::BaselineWalkingController(mc_rbdyn::RobotModulePtr rm,
                                                      double dt,
                                                      const mc_rtc::Configuration & _config)
@@ -67,28 +96,33 @@ BaselineWalkingController::BaselineWalkingController(mc_rbdyn::RobotModulePtr rm
   }
   if(config().has("CentroidalManager"))
   {
-    std::string centroidalManagerMethod = config()("CentroidalManager")("method", std::string(""));
-    if(centroidalManagerMethod == "PreviewControlZmp")
-    {
-      centroidalManager_ = std::make_shared<CentroidalManagerPreviewControlZmp>(this, config()("CentroidalManager"));
-    }
-    else if(centroidalManagerMethod == "DdpZmp")
-    {
-      centroidalManager_ = std::make_shared<CentroidalManagerDdpZmp>(this, config()("CentroidalManager"));
-    }
-    else if(centroidalManagerMethod == "FootGuidedControl")
-    {
-      centroidalManager_ = std::make_shared<CentroidalManagerFootGuidedControl>(this, config()("CentroidalManager"));
-    }
-    else if(centroidalManagerMethod == "IntrinsicallyStableMpc")
-    {
-      centroidalManager_ =
-          std::make_shared<CentroidalManagerIntrinsicallyStableMpc>(this, config()("CentroidalManager"));
-    }
-    else
+    const auto & centroidalManagerConfig = config()("CentroidalManager");
+    std::string centroidalManagerMethod = centroidalManagerConfig("method", std::string(""));
+    centroidalManager_ = makeCentroidalManager(this, centroidalManagerMethod, centroidalManagerConfig);
+
+    // The fallback manager is constructed in advance so that it can be switched to without delay
+    std::string fallbackMethod = centroidalManagerConfig("fallbackMethod", std::string(""));
+    if(!fallbackMethod.empty())
     {
-      mc_rtc::log::error_and_throw("[BaselineWalkingController] Invalid centroidalManagerMethod: {}.",
-                                   centroidalManagerMethod);
+      if(fallbackMethod == centroidalManagerMethod)
+      {
+        mc_rtc::log::error_and_throw("[BaselineWalkingController] fallbackMethod must differ from method: {}.",
+                                     fallbackMethod);
+      }
+      if(centroidalManagerConfig("enableAsyncMpc", false))
+      {
+        mc_rtc::log::error_and_throw(
+            "[BaselineWalkingController] fallbackMethod cannot be used with enableAsyncMpc: {}.", fallbackMethod);
+      }
+      mc_rtc::Configuration fallbackConfig;
+      fallbackConfig.load(centroidalManagerConfig);
+      if(centroidalManagerConfig.has("fallbackConfig"))
+      {
+        fallbackConfig.load(centroidalManagerConfig("fallbackConfig"));
+      }
+      fallbackConfig.add("method", fallbackMethod);
+      fallbackConfig.add("enableAsyncMpc", false);
+      centroidalManager_->setFallback(makeCentroidalManager(this, fallbackMethod, fallbackConfig));
     }
   }
   else
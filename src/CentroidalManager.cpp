@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <chrono>
+
 #include <mc_rtc/gui/Checkbox.h>
 #include <mc_rtc/gui/Label.h>
 #include <mc_rtc/gui/NumberInput.h>
@@ -19,6 +22,12 @@ void CentroidalManager::Configuration::load(const mc_rtc::Configuration & mcRtcC
   mcRtcConfig("name", name);
   mcRtcConfig("method", method);
   mcRtcConfig("useActualStateForMpc", useActualStateForMpc);
+  mcRtcConfig("enableAsyncMpc", enableAsyncMpc);
+  mcRtcConfig("asyncMpcPeriod", asyncMpcPeriod);
+  mcRtcConfig("fallbackMethod", fallbackMethod);
+  mcRtcConfig("mpcDeadline", mpcDeadline);
+  mcRtcConfig("fallbackOverrunNum", fallbackOverrunNum);
+  mcRtcConfig("fallbackDuration", fallbackDuration);
   mcRtcConfig("enableZmpFeedback", enableZmpFeedback);
   mcRtcConfig("enableComZFeedback", enableComZFeedback);
   mcRtcConfig("dcmGainP", dcmGainP);
@@ -36,29 +45,77 @@ CentroidalManager::CentroidalManager(BaselineWalkingController * ctlPtr, const m
 {
 }
 
+CentroidalManager::~CentroidalManager()
+{
+  stopMpcThread();
+}
+
 void CentroidalManager::reset()
 {
   robotMass_ = ctl().robot().mass();
+
+  wrenchDist_.reset();
+  for(auto & wrenchDist : wrenchDistPool_)
+  {
+    wrenchDist.reset();
+  }
+
+  refDataDt_ = 0;
+
+  stopMpcThread();
+  mpcInputList_.clear();
+  mpcPlan_ = MpcPlan();
+  mpcPlan_.startTime = std::numeric_limits<double>::lowest();
+  mpcPlanBuffers_.fill(mpcPlan_);
+  mpcPlanFrontIdx_ = 0;
+  nextMpcRequestTime_ = std::numeric_limits<double>::lowest();
+  if(config().enableAsyncMpc)
+  {
+    startMpcThread();
+  }
+
+  if(fallback_)
+  {
+    fallback_->reset();
+  }
+  fallbackActive_ = false;
+  mpcOverrunCount_ = 0;
+  mpcSwitchTime_ = ctl().t();
 }
 
 void CentroidalManager::update()
 {
   // Set MPC state
+  Eigen::Vector3d com;
+  Eigen::Vector3d comVel;
   if(config().useActualStateForMpc)
   {
-    mpcCom_ = ctl().realRobot().com();
-    mpcComVel_ = ctl().realRobot().comVelocity();
+    com = ctl().realRobot().com();
+    comVel = ctl().realRobot().comVelocity();
   }
   else
   {
     // Task targets are the planned state in the previous step
-    mpcCom_ = ctl().comTask_->com();
-    mpcComVel_ = ctl().comTask_->refVel();
+    com = ctl().comTask_->com();
+    comVel = ctl().comTask_->refVel();
   }
   refZmp_ = ctl().footManager_->calcRefZmp(ctl().t());
 
   // Run MPC
-  runMpc();
+  if(config().enableAsyncMpc)
+  {
+    updateAsyncMpc(com, comVel);
+  }
+  else
+  {
+    mpcTime_ = ctl().t();
+    mpcCom_ = com;
+    mpcComVel_ = comVel;
+    updateSyncMpc();
+  }
+  Eigen::Vector3d plannedInput = mpcPlan_.calcInput(ctl().t());
+  plannedZmp_ << plannedInput.head<2>(), refZmp_.z();
+  plannedForceZ_ = plannedInput.z();
 
   // Calculate target wrench
   {
@@ -73,7 +130,7 @@ void CentroidalManager::update()
     // Apply DCM feedback
     if(config().enableZmpFeedback)
     {
-      double omega = std::sqrt(plannedForceZ_ / (robotMass_ * (mpcCom_.z() - refZmp_.z())));
+      double omega = std::sqrt(plannedForceZ_ / (robotMass_ * (com.z() - refZmp_.z())));
       Eigen::Vector3d plannedDcm = ctl().comTask_->com() + ctl().comTask_->refVel() / omega;
       Eigen::Vector3d actualDcm = ctl().realRobot().com() + ctl().realRobot().comVelocity() / omega;
       controlZmp_.head<2>() += config().dcmGainP * (actualDcm - plannedDcm).head<2>();
@@ -92,10 +149,7 @@ void CentroidalManager::update()
 
     // Convert ZMP to wrench and distribute
     contactList_ = ctl().footManager_->calcCurrentContactList();
-    if(!wrenchDist_ || wrenchDist_->contactList_ != contactList_)
-    {
-      wrenchDist_ = std::make_shared<WrenchDistribution>(contactList_, config().wrenchDistConfig);
-    }
+    wrenchDist_ = getPooledWrenchDist(contactList_);
     Eigen::Vector3d comForWrenchDist =
         (config().useActualComForWrenchDist ? ctl().realRobot().com() : ctl().comTask_->com());
     sva::ForceVecd controlWrench;
@@ -109,10 +163,9 @@ void CentroidalManager::update()
   // Set target of tasks
   {
     // Set target of CoM task
-    Eigen::Vector3d plannedComAccel = calcPlannedComAccel();
-    Eigen::Vector3d nextPlannedCom =
-        mpcCom_ + ctl().dt() * mpcComVel_ + 0.5 * std::pow(ctl().dt(), 2) * plannedComAccel;
-    Eigen::Vector3d nextPlannedComVel = mpcComVel_ + ctl().dt() * plannedComAccel;
+    Eigen::Vector3d plannedComAccel = calcPlannedComAccel(com);
+    Eigen::Vector3d nextPlannedCom = com + ctl().dt() * comVel + 0.5 * std::pow(ctl().dt(), 2) * plannedComAccel;
+    Eigen::Vector3d nextPlannedComVel = comVel + ctl().dt() * plannedComAccel;
     if(isConstantComZ())
     {
       nextPlannedCom.z() = config().refComZ + ctl().footManager_->calcRefGroundPosZ(ctl().t());
@@ -141,6 +194,8 @@ void CentroidalManager::stop()
 {
   removeFromGUI(*ctl().gui());
   removeFromLogger(ctl().logger());
+
+  stopMpcThread();
 }
 
 void CentroidalManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
@@ -187,6 +242,9 @@ void CentroidalManager::addToLogger(mc_rtc::Logger & logger)
   logger.addLogEntry(config().name + "_Config_method", this, [this]() { return config().method; });
   logger.addLogEntry(config().name + "_Config_useActualStateForMpc", this,
                      [this]() { return config().useActualStateForMpc; });
+  logger.addLogEntry(config().name + "_Config_enableAsyncMpc", this, [this]() { return config().enableAsyncMpc; });
+  logger.addLogEntry(config().name + "_Config_asyncMpcPeriod", this, [this]() { return config().asyncMpcPeriod; });
+  logger.addLogEntry(config().name + "_Config_mpcDeadline", this, [this]() { return config().mpcDeadline; });
   logger.addLogEntry(config().name + "_Config_enableZmpFeedback", this,
                      [this]() { return config().enableZmpFeedback; });
   logger.addLogEntry(config().name + "_Config_enableComZFeedback", this,
@@ -201,7 +259,7 @@ void CentroidalManager::addToLogger(mc_rtc::Logger & logger)
   logger.addLogEntry(config().name + "_Config_useActualComForWrenchDist", this,
                      [this]() { return config().useActualComForWrenchDist; });
 
-  MC_RTC_LOG_HELPER(config().name + "_CoM_MPC", mpcCom_);
+  logger.addLogEntry(config().name + "_CoM_MPC", this, [this]() { return mpcPlan_.com; });
   logger.addLogEntry(config().name + "_CoM_planned", this, [this]() { return ctl().comTask_->com(); });
   logger.addLogEntry(config().name + "_CoM_controlRobot", this, [this]() { return ctl().robot().com(); });
   logger.addLogEntry(config().name + "_CoM_realRobot", this, [this]() { return ctl().realRobot().com(); });
@@ -216,7 +274,7 @@ void CentroidalManager::addToLogger(mc_rtc::Logger & logger)
     return wrenchDist_ ? calcZmp(wrenchDist_->calcWrenchList(), refZmp_.z()) : Eigen::Vector3d::Zero();
   });
   logger.addLogEntry(config().name + "_ZMP_measured", this, [this]() {
-    std::unordered_map<Foot, sva::ForceVecd> sensorWrenchList;
+    FootMap<sva::ForceVecd> sensorWrenchList;
     for(const auto & foot : ctl().footManager_->getCurrentContactFeet())
     {
       const auto & surfaceName = ctl().footManager_->surfaceName(foot);
@@ -249,6 +307,17 @@ void CentroidalManager::addToLogger(mc_rtc::Logger & logger)
     }
     return maxPos;
   });
+
+  logger.addLogEntry(config().name + "_MPC_planAge", this, [this]() { return ctl().t() - mpcPlan_.startTime; });
+  logger.addLogEntry(config().name + "_MPC_solveDuration", this, [this]() { return mpcPlan_.solveDuration; });
+  MC_RTC_LOG_HELPER(config().name + "_MPC_fallbackActive", fallbackActive_);
+
+  logger.addLogEntry(config().name + "_WrenchDist_warmStarted", this,
+                     [this]() { return wrenchDist_ ? wrenchDist_->solveStat().warmStarted : false; });
+  logger.addLogEntry(config().name + "_WrenchDist_iterNum", this,
+                     [this]() { return wrenchDist_ ? wrenchDist_->solveStat().iterNum : 0; });
+  logger.addLogEntry(config().name + "_WrenchDist_computationDuration", this,
+                     [this]() { return wrenchDist_ ? wrenchDist_->solveStat().duration : 0.0; });
 }
 
 void CentroidalManager::removeFromLogger(mc_rtc::Logger & logger)
@@ -256,6 +325,13 @@ void CentroidalManager::removeFromLogger(mc_rtc::Logger & logger)
   logger.removeLogEntries(this);
 }
 
+void CentroidalManager::setFallback(const std::shared_ptr<CentroidalManager> & fallback)
+{
+  fallback_ = fallback;
+  fallbackActive_ = false;
+  mpcOverrunCount_ = 0;
+}
+
 void CentroidalManager::setAnchorFrame()
 {
   std::string anchorName = "KinematicAnchorFrame::" + ctl().robot().name();
@@ -283,7 +359,7 @@ sva::PTransformd CentroidalManager::calcAnchorFrame(const mc_rbdyn::Robot & robo
   }
 }
 
-Eigen::Vector3d CentroidalManager::calcZmp(const std::unordered_map<Foot, sva::ForceVecd> & wrenchList,
+Eigen::Vector3d CentroidalManager::calcZmp(const FootMap<sva::ForceVecd> & wrenchList,
                                            double zmpPlaneHeight,
                                            const Eigen::Vector3d & zmpPlaneNormal) const
 {
@@ -305,12 +381,298 @@ Eigen::Vector3d CentroidalManager::calcZmp(const std::unordered_map<Foot, sva::F
   return zmp;
 }
 
-Eigen::Vector3d CentroidalManager::calcPlannedComAccel() const
+std::shared_ptr<WrenchDistribution> CentroidalManager::getPooledWrenchDist(
+    const FootMap<std::shared_ptr<Contact>> & contactList)
+{
+  size_t poolIdx = contactList.feet().bits();
+
+  auto & wrenchDist = wrenchDistPool_.at(poolIdx);
+  if(wrenchDist)
+  {
+    wrenchDist->setContactList(contactList);
+  }
+  else
+  {
+    wrenchDist = std::make_shared<WrenchDistribution>(contactList, config().wrenchDistConfig);
+  }
+  return wrenchDist;
+}
+
+void CentroidalManager::calcRefDataList(double horizonDuration, double horizonDt, bool withGroundPosZ)
+{
+  int sampleNum = static_cast<int>(std::floor(horizonDuration / horizonDt)) + 1;
+  if(refZmpList_.cols() != sampleNum)
+  {
+    refZmpList_.resize(3, sampleNum);
+  }
+  refDataStartTime_ = mpcTime_;
+  refDataDt_ = horizonDt;
+
+  ctl().footManager_->calcRefZmpList(refDataStartTime_, refDataDt_, refZmpList_);
+  if(withGroundPosZ)
+  {
+    if(refGroundPosZList_.size() != sampleNum)
+    {
+      refGroundPosZList_.resize(sampleNum);
+    }
+    ctl().footManager_->calcRefGroundPosZList(refDataStartTime_, refDataDt_, refGroundPosZList_);
+  }
+  else
+  {
+    refGroundPosZList_.resize(0);
+  }
+}
+
+int CentroidalManager::refDataIdx(double t) const
+{
+  if(refDataDt_ <= 0)
+  {
+    return -1;
+  }
+  double idx = std::round((t - refDataStartTime_) / refDataDt_);
+  if(idx < 0 || idx >= static_cast<double>(refZmpList_.cols())
+     || std::abs(t - (refDataStartTime_ + idx * refDataDt_)) > 1e-8)
+  {
+    return -1;
+  }
+  return static_cast<int>(idx);
+}
+
+int CentroidalManager::nearestRefDataIdx(double t) const
+{
+  if(refDataDt_ <= 0 || refZmpList_.cols() == 0)
+  {
+    return -1;
+  }
+  double idx = std::round((t - refDataStartTime_) / refDataDt_);
+  return static_cast<int>(std::clamp(idx, 0.0, static_cast<double>(refZmpList_.cols() - 1)));
+}
+
+Eigen::Vector3d CentroidalManager::calcPlannedComAccel(const Eigen::Vector3d & com) const
 {
   Eigen::Vector3d plannedComAccel;
-  plannedComAccel << plannedForceZ_ / (robotMass_ * (mpcCom_.z() - refZmp_.z()))
-                         * (mpcCom_.head<2>() - plannedZmp_.head<2>()),
+  plannedComAccel << plannedForceZ_ / (robotMass_ * (com.z() - refZmp_.z())) * (com.head<2>() - plannedZmp_.head<2>()),
       plannedForceZ_ / robotMass_;
   plannedComAccel.z() -= CCC::constants::g;
   return plannedComAccel;
 }
+
+void CentroidalManager::setMpcWarmStart(const Eigen::Vector2d & zmp, double forceZ)
+{
+  mpcZmp_ = zmp;
+  mpcForceZ_ = forceZ;
+}
+
+Eigen::Vector3d CentroidalManager::MpcPlan::calcInput(double t) const
+{
+  if(inputList.empty() || inputDt <= 0)
+  {
+    return Eigen::Vector3d(zmp.x(), zmp.y(), forceZ);
+  }
+
+  double idx = std::clamp((t - startTime) / inputDt, 0.0, static_cast<double>(inputList.size() - 1));
+  size_t idxFloor = static_cast<size_t>(std::floor(idx));
+  size_t idxCeil = std::min(idxFloor + 1, inputList.size() - 1);
+  double ratio = idx - static_cast<double>(idxFloor);
+  return (1 - ratio) * inputList[idxFloor] + ratio * inputList[idxCeil];
+}
+
+void CentroidalManager::prepareMpc()
+{
+  mpcRefComZ_ = config().refComZ;
+  mpcAsync_ = config().enableAsyncMpc;
+}
+
+void CentroidalManager::updateSyncMpc()
+{
+  CentroidalManager & mpcManager = (fallbackActive_ ? *fallback_ : *this);
+  if(fallbackActive_)
+  {
+    mpcManager.mpcTime_ = mpcTime_;
+    mpcManager.mpcCom_ = mpcCom_;
+    mpcManager.mpcComVel_ = mpcComVel_;
+  }
+
+  auto startTime = std::chrono::steady_clock::now();
+
+  mpcManager.prepareMpc();
+  mpcManager.runMpc();
+
+  mpcPlan_.startTime = mpcTime_;
+  mpcPlan_.com = mpcCom_;
+  mpcPlan_.comVel = mpcComVel_;
+  mpcPlan_.zmp = mpcManager.mpcZmp_;
+  mpcPlan_.forceZ = mpcManager.mpcForceZ_;
+  mpcPlan_.inputList = mpcManager.mpcInputList_;
+  mpcPlan_.inputDt = mpcManager.mpcInputDt_;
+  mpcPlan_.solveDuration =
+      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+  if(fallback_ && !config().enableAsyncMpc)
+  {
+    updateFallback();
+  }
+}
+
+void CentroidalManager::updateFallback()
+{
+  if(fallbackActive_)
+  {
+    // Retry the original method after a while
+    if(ctl().t() - mpcSwitchTime_ >= config().fallbackDuration)
+    {
+      switchMpcMethod(false);
+
+      // Switch to the fallback method again if the original method overruns in the first cycle
+      mpcOverrunCount_ = config().fallbackOverrunNum - 1;
+    }
+    return;
+  }
+
+  if(mpcPlan_.solveDuration > config().mpcDeadline)
+  {
+    mpcOverrunCount_++;
+  }
+  else
+  {
+    mpcOverrunCount_ = 0;
+  }
+
+  if(mpcOverrunCount_ >= config().fallbackOverrunNum)
+  {
+    // Do not repeat the warning while retrying the original method
+    if(ctl().t() - mpcSwitchTime_ > ctl().dt() + 1e-8)
+    {
+      mc_rtc::log::warning("[CentroidalManager] MPC overran the deadline {} times in a row. Switch to {}.",
+                           mpcOverrunCount_, fallback_->config().method);
+    }
+    switchMpcMethod(true);
+  }
+}
+
+void CentroidalManager::switchMpcMethod(bool useFallback)
+{
+  // Since the planned CoM is held by the CoM task, only the MPC warm start needs to be transferred
+  CentroidalManager & nextManager = (useFallback ? *fallback_ : *this);
+  nextManager.setMpcWarmStart(mpcPlan_.zmp, mpcPlan_.forceZ);
+
+  fallbackActive_ = useFallback;
+  mpcOverrunCount_ = 0;
+  mpcSwitchTime_ = ctl().t();
+}
+
+void CentroidalManager::updateAsyncMpc(const Eigen::Vector3d & com, const Eigen::Vector3d & comVel)
+{
+  // Run MPC in the control thread until the first plan is available
+  if(mpcPlan_.startTime == std::numeric_limits<double>::lowest())
+  {
+    mpcTime_ = ctl().t();
+    mpcCom_ = com;
+    mpcComVel_ = comVel;
+    updateSyncMpc();
+    nextMpcRequestTime_ = ctl().t();
+  }
+
+  // Apply the latest published plan when its initial time comes
+  // The MPC thread only writes to the back buffer, so the front buffer can be read without lock
+  const MpcPlan & latestPlan = mpcPlanBuffers_[mpcPlanFrontIdx_.load(std::memory_order_acquire)];
+  if(latestPlan.startTime > mpcPlan_.startTime && latestPlan.startTime <= ctl().t() + 0.5 * ctl().dt())
+  {
+    mpcPlan_ = latestPlan;
+  }
+
+  // Request the next MPC if the MPC thread is idle
+  if(mpcRequested_.load(std::memory_order_acquire) || ctl().t() < nextMpcRequestTime_ - 0.5 * ctl().dt())
+  {
+    return;
+  }
+
+  // The MPC thread holds the lock only while checking the request, so the control thread does not wait for it
+  std::unique_lock<std::mutex> lock(mpcMutex_, std::try_to_lock);
+  if(!lock.owns_lock())
+  {
+    // Retry in the next control cycle
+    return;
+  }
+
+  // Compensate the latency by starting MPC from the state predicted at the time when its result is applied
+  double period = config().asyncMpcPeriod;
+  Eigen::Vector3d plannedInput = mpcPlan_.calcInput(ctl().t());
+  plannedZmp_ << plannedInput.head<2>(), refZmp_.z();
+  plannedForceZ_ = plannedInput.z();
+  Eigen::Vector3d comAccel = calcPlannedComAccel(com);
+  mpcTime_ = ctl().t() + period;
+  mpcCom_ = com + period * comVel + 0.5 * std::pow(period, 2) * comAccel;
+  mpcComVel_ = comVel + period * comAccel;
+  if(isConstantComZ())
+  {
+    mpcCom_.z() = config().refComZ + ctl().footManager_->calcRefGroundPosZ(mpcTime_);
+    mpcComVel_.z() = ctl().footManager_->calcRefGroundPosZ(mpcTime_, 1);
+  }
+  prepareMpc();
+
+  nextMpcRequestTime_ = mpcTime_;
+  mpcRequested_.store(true, std::memory_order_release);
+  lock.unlock();
+  mpcCond_.notify_one();
+}
+
+void CentroidalManager::startMpcThread()
+{
+  if(mpcThreadRunning_)
+  {
+    return;
+  }
+
+  mpcThreadRunning_ = true;
+  mpcThread_ = std::thread(&CentroidalManager::mpcThread, this);
+}
+
+void CentroidalManager::stopMpcThread()
+{
+  {
+    std::lock_guard<std::mutex> lock(mpcMutex_);
+    mpcThreadRunning_ = false;
+  }
+  mpcCond_.notify_one();
+  if(mpcThread_.joinable())
+  {
+    mpcThread_.join();
+  }
+
+  mpcRequested_ = false;
+}
+
+void CentroidalManager::mpcThread()
+{
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mpcMutex_);
+      mpcCond_.wait(lock, [this]() { return mpcRequested_.load(std::memory_order_acquire) || !mpcThreadRunning_; });
+    }
+    if(!mpcThreadRunning_)
+    {
+      break;
+    }
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    runMpc();
+
+    size_t backIdx = 1 - mpcPlanFrontIdx_.load(std::memory_order_relaxed);
+    MpcPlan & plan = mpcPlanBuffers_[backIdx];
+    plan.startTime = mpcTime_;
+    plan.com = mpcCom_;
+    plan.comVel = mpcComVel_;
+    plan.zmp = mpcZmp_;
+    plan.forceZ = mpcForceZ_;
+    plan.inputList = mpcInputList_;
+    plan.inputDt = mpcInputDt_;
+    plan.solveDuration =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    mpcPlanFrontIdx_.store(backIdx, std::memory_order_release);
+
+    mpcRequested_.store(false, std::memory_order_release);
+  }
+}
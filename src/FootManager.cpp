@@ -16,6 +16,78 @@
 
 using namespace BWC;
 
+namespace
+{
+double calcFootMidposZ(const FootMap<sva::PTransformd> & footPoses)
+{
+  return 0.5 * (footPoses.at(Foot::Left).translation().z() + footPoses.at(Foot::Right).translation().z());
+}
+
+/** \brief Calculate the waypoints of swing position depending on the swing start pose.
+
+    Returns the start of withdraw, end of withdraw, and middle of swing.
+*/
+std::array<Eigen::Vector3d, 3> calcSwingStartWaypoints(const Footstep & footstep,
+                                                       const sva::PTransformd & swingStartPose,
+                                                       const sva::PTransformd & swingGoalPose)
+{
+  return {swingStartPose.translation(),
+          (sva::PTransformd(footstep.config.withdrawOffset) * swingStartPose).translation(),
+          (sva::PTransformd(footstep.config.swingOffset) * sva::interpolate(swingStartPose, swingGoalPose, 0.5))
+              .translation()};
+}
+
+/** \brief Make the function of swing position.
+
+    The function consists of the splines to withdraw, swing, and approach foot. The waypoints of approach are the start
+    and end of approach.
+*/
+std::shared_ptr<PiecewisePolynomial<Eigen::Vector3d, 3>> makeSwingPosFunc(
+    const Footstep & footstep,
+    double withdrawDuration,
+    double approachDuration,
+    const std::array<Eigen::Vector3d, 3> & startWaypoints,
+    const std::array<Eigen::Vector3d, 2> & endWaypoints)
+{
+  BoundaryConstraint<Eigen::Vector3d> zeroVelBC(BoundaryConstraintType::Velocity, Eigen::Vector3d::Zero());
+  BoundaryConstraint<Eigen::Vector3d> zeroAccelBC(BoundaryConstraintType::Acceleration, Eigen::Vector3d::Zero());
+
+  // Spline to withdraw foot
+  std::map<double, Eigen::Vector3d> withdrawPosWaypoints = {
+      {footstep.swingStartTime, startWaypoints[0]},
+      {footstep.swingStartTime + withdrawDuration, startWaypoints[1]}};
+  CubicSpline<Eigen::Vector3d> withdrawPosSpline(3, withdrawPosWaypoints, zeroVelBC, zeroAccelBC);
+  withdrawPosSpline.calcCoeff();
+
+  // Spline to approach foot
+  std::map<double, Eigen::Vector3d> approachPosWaypoints = {
+      {footstep.swingEndTime - approachDuration, endWaypoints[0]}, {footstep.swingEndTime, endWaypoints[1]}};
+  CubicSpline<Eigen::Vector3d> approachPosSpline(3, approachPosWaypoints, zeroAccelBC, zeroVelBC);
+  approachPosSpline.calcCoeff();
+
+  // Spline to swing foot
+  std::map<double, Eigen::Vector3d> swingPosWaypoints = {
+      *withdrawPosWaypoints.rbegin(),
+      {0.5 * (footstep.swingStartTime + footstep.swingEndTime), startWaypoints[2]},
+      *approachPosWaypoints.begin()};
+  CubicSpline<Eigen::Vector3d> swingPosSpline(
+      3, swingPosWaypoints,
+      BoundaryConstraint<Eigen::Vector3d>(
+          BoundaryConstraintType::Velocity,
+          withdrawPosSpline.derivative(footstep.swingStartTime + withdrawDuration, 1)),
+      BoundaryConstraint<Eigen::Vector3d>(BoundaryConstraintType::Velocity,
+                                          approachPosSpline.derivative(footstep.swingEndTime - approachDuration, 1)));
+  swingPosSpline.calcCoeff();
+
+  // Segments are concatenated in chronological order
+  auto swingPosFunc = std::make_shared<PiecewisePolynomial<Eigen::Vector3d, 3>>();
+  swingPosFunc->appendSegments(withdrawPosSpline);
+  swingPosFunc->appendSegments(swingPosSpline);
+  swingPosFunc->appendSegments(approachPosSpline);
+  return swingPosFunc;
+}
+} // namespace
+
 void FootManager::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
 {
   mcRtcConfig("name", name);
@@ -28,9 +100,11 @@ void FootManager::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
       mcRtcConfig("midToFootTranss")(std::to_string(foot), midToFootTranss.at(foot));
     }
   }
+  mcRtcConfig("footstepQueueCapacity", footstepQueueCapacity);
   mcRtcConfig("zmpHorizon", zmpHorizon);
   mcRtcConfig("zmpOffset", zmpOffset);
   mcRtcConfig("overwriteLandingPose", overwriteLandingPose);
+  mcRtcConfig("precomputeSwingTraj", precomputeSwingTraj);
   mcRtcConfig("stopSwingTrajForTouchDownFoot", stopSwingTrajForTouchDownFoot);
   mcRtcConfig("keepSupportFootPoseForTouchDownFoot", keepSupportFootPoseForTouchDownFoot);
   mcRtcConfig("enableWrenchDistForTouchDownFoot", enableWrenchDistForTouchDownFoot);
@@ -38,29 +112,41 @@ void FootManager::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
   mcRtcConfig("touchDownRemainingDuration", touchDownRemainingDuration);
   mcRtcConfig("touchDownPosError", touchDownPosError);
   mcRtcConfig("touchDownForceZ", touchDownForceZ);
+  mcRtcConfig("footstepMarkerUpdatePeriod", footstepMarkerUpdatePeriod);
   if(mcRtcConfig.has("impedanceGains"))
   {
-    mcRtcConfig("impedanceGains")("singleSupport", impGains.at("singleSupport"));
-    mcRtcConfig("impedanceGains")("doubleSupport", impGains.at("doubleSupport"));
-    mcRtcConfig("impedanceGains")("swing", impGains.at("swing"));
+    for(const auto & impGainType : ImpGainTypes::All)
+    {
+      mcRtcConfig("impedanceGains")(std::to_string(impGainType), impGains[static_cast<size_t>(impGainType)]);
+    }
   }
 }
 
 FootManager::FootManager(BaselineWalkingController * ctlPtr, const mc_rtc::Configuration & mcRtcConfig)
 : ctlPtr_(ctlPtr), zmpFunc_(std::make_shared<CubicInterpolator<Eigen::Vector3d>>()),
   groundPosZFunc_(std::make_shared<CubicInterpolator<double>>()),
-  swingPosFunc_(std::make_shared<PiecewiseFunc<Eigen::Vector3d>>()),
+  swingPosFunc_(std::make_shared<PiecewisePolynomial<Eigen::Vector3d, 3>>()),
   swingRotFunc_(std::make_shared<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>()),
   baseYawFunc_(std::make_shared<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>())
 {
   config_.load(mcRtcConfig);
+
+  footstepQueue_.reset(config_.footstepQueueCapacity);
+}
+
+FootManager::~FootManager()
+{
+  stopSwingTrajThread();
 }
 
 void FootManager::reset()
 {
   footstepQueue_.clear();
+  footstepQueueVersion_++;
   prevFootstep_.reset();
 
+  updateLocalVertexLists();
+
   for(const auto & foot : Feet::Both)
   {
     targetFootPoses_.emplace(foot, ctl().robot().surfacePose(surfaceName(foot)));
@@ -72,36 +158,51 @@ void FootManager::reset()
   supportPhase_ = SupportPhase::DoubleSupport;
 
   Eigen::Vector3d targetZmp = calcZmpWithOffset(targetFootPoses_);
+  double refGroundPosZ = calcFootMidposZ(targetFootPoses_);
+  gaitTimeline_.clear();
   zmpFunc_->clearPoints();
-  zmpFunc_->appendPoint(std::make_pair(ctl().t(), targetZmp));
-  zmpFunc_->appendPoint(std::make_pair(ctl().t() + config_.zmpHorizon, targetZmp));
-  zmpFunc_->calcCoeff();
-
-  double refGroundPosZ =
-      0.5 * (targetFootPoses_.at(Foot::Left).translation().z() + targetFootPoses_.at(Foot::Right).translation().z());
   groundPosZFunc_->clearPoints();
-  groundPosZFunc_->appendPoint(std::make_pair(ctl().t(), refGroundPosZ));
-  groundPosZFunc_->appendPoint(std::make_pair(ctl().t() + config_.zmpHorizon, refGroundPosZ));
+  appendGaitPhase(ctl().t(), targetZmp, refGroundPosZ, targetFootPoses_);
+  appendGaitPhase(ctl().t() + config_.zmpHorizon, targetZmp, refGroundPosZ, targetFootPoses_);
+  zmpFunc_->calcCoeff();
   groundPosZFunc_->calcCoeff();
 
-  contactFootPosesList_.emplace(ctl().t(), targetFootPoses_);
+  swingFootstepHandle_ = {};
 
-  swingFootstep_ = nullptr;
+  footContacts_.clear();
+  currentContactList_.clear();
 
-  swingPosFunc_->clearFuncs();
+  swingPosFunc_->clearSegments();
   swingRotFunc_->clearPoints();
 
   baseYawFunc_->clearPoints();
 
+  {
+    std::lock_guard<std::mutex> lock(swingTrajMutex_);
+    swingTrajRequest_.reset();
+    swingTrajResult_.reset();
+  }
+  lastSwingTrajRequest_.reset();
+  if(config_.precomputeSwingTraj)
+  {
+    startSwingTrajThread();
+  }
+
   touchDown_ = false;
 
   for(const auto & foot : Feet::Both)
   {
-    impGainTypes_.emplace(foot, "doubleSupport");
+    impGainTypes_.emplace(foot, ImpGainType::DoubleSupport);
   }
 
   requireImpGainUpdate_ = true;
 
+  for(auto & footstepMarkerBuffer : footstepMarkerBuffers_)
+  {
+    footstepMarkerBuffer.clear();
+  }
+  footstepMarkerUpdateTime_ = std::numeric_limits<double>::lowest();
+
   overwriteLandingPosLowPass_.dt(ctl().solver().dt());
   overwriteLandingPosLowPass_.reset(Eigen::Vector3d::Zero());
 }
@@ -116,6 +217,8 @@ void FootManager::stop()
 {
   removeFromGUI(*ctl().gui());
   removeFromLogger(ctl().logger());
+
+  stopSwingTrajThread();
 }
 
 void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
@@ -127,8 +230,10 @@ void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
                  mc_rtc::gui::Label("LeftFootSurface", [this]() { return surfaceName(Foot::Left); }),
                  mc_rtc::gui::Label("RightFootSurface", [this]() { return surfaceName(Foot::Right); }));
   gui.addElement({ctl().name(), config_.name, "Status"}, mc_rtc::gui::ElementsStacking::Horizontal,
-                 mc_rtc::gui::Label("LeftImpGainType", [this]() { return impGainTypes_.at(Foot::Left); }),
-                 mc_rtc::gui::Label("RightImpGainType", [this]() { return impGainTypes_.at(Foot::Right); }));
+                 mc_rtc::gui::Label("LeftImpGainType",
+                                    [this]() { return std::to_string(impGainTypes_.at(Foot::Left)); }),
+                 mc_rtc::gui::Label("RightImpGainType",
+                                    [this]() { return std::to_string(impGainTypes_.at(Foot::Right)); }));
 
   gui.addElement(
       {ctl().name(), config_.name, "Config"},
@@ -140,7 +245,10 @@ void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
           [this](double v) { config_.doubleSupportRatio = v; }),
       mc_rtc::gui::ArrayInput(
           "zmpOffset", {"x", "y", "z"}, [this]() -> const Eigen::Vector3d & { return config_.zmpOffset; },
-          [this](const Eigen::Vector3d & v) { config_.zmpOffset = v; }),
+          [this](const Eigen::Vector3d & v) {
+            config_.zmpOffset = v;
+            footstepQueueVersion_++;
+          }),
       mc_rtc::gui::Checkbox(
           "overwriteLandingPose", [this]() { return config_.overwriteLandingPose; },
           [this]() { config_.overwriteLandingPose = !config_.overwriteLandingPose; }),
@@ -163,39 +271,55 @@ void FootManager::addToGUI(mc_rtc::gui::StateBuilder & gui)
           [this](double v) { config_.touchDownPosError = v; }),
       mc_rtc::gui::NumberInput(
           "touchDownForceZ", [this]() { return config_.touchDownForceZ; },
-          [this](double v) { config_.touchDownForceZ = v; }));
-
-  for(const auto & impGainKV : config_.impGains)
+          [this](double v) { config_.touchDownForceZ = v; }),
+      mc_rtc::gui::NumberInput(
+          "footstepMarkerUpdatePeriod", [this]() { return config_.footstepMarkerUpdatePeriod; },
+          [this](double v) { config_.footstepMarkerUpdatePeriod = v; }));
+
+  gui.addElement({ctl().name(), config_.name, "FootstepMarker"},
+                 mc_rtc::gui::Polygon("Footstep", {mc_rtc::gui::Color::Blue, 0.02}, [this]() {
+                   // Take the middle buffer only if it has been written since the last read
+                   if(footstepMarkerMiddleIdx_.load(std::memory_order_relaxed) & footstepMarkerFreshBit)
+                   {
+                     footstepMarkerFrontIdx_ =
+                         footstepMarkerMiddleIdx_.exchange(footstepMarkerFrontIdx_, std::memory_order_acq_rel)
+                         & ~footstepMarkerFreshBit;
+                   }
+                   return footstepMarkerBuffers_[footstepMarkerFrontIdx_];
+                 }));
+
+  for(const auto & impGainType : ImpGainTypes::All)
   {
-    const auto & impGainType = impGainKV.first;
-    gui.addElement({ctl().name(), config_.name, "ImpedanceGains", impGainType},
+    size_t impGainIdx = static_cast<size_t>(impGainType);
+    const std::string & impGainTypeStr = std::to_string(impGainType);
+    gui.addElement({ctl().name(), config_.name, "ImpedanceGains", impGainTypeStr},
                    mc_rtc::gui::ArrayInput(
                        "Damper", {"cx", "cy", "cz", "fx", "fy", "fz"},
-                       [this, impGainType]() -> const sva::ImpedanceVecd & {
-                         return config_.impGains.at(impGainType).damper().vec();
+                       [this, impGainIdx]() -> const sva::ImpedanceVecd & {
+                         return config_.impGains[impGainIdx].damper().vec();
                        },
-                       [this, impGainType](const Eigen::Vector6d & v) {
-                         config_.impGains.at(impGainType).damper().vec(v);
+                       [this, impGainIdx](const Eigen::Vector6d & v) {
+                         config_.impGains[impGainIdx].damper().vec(v);
                          requireImpGainUpdate_ = true;
                        }));
-    gui.addElement({ctl().name(), config_.name, "ImpedanceGains", impGainType},
+    gui.addElement({ctl().name(), config_.name, "ImpedanceGains", impGainTypeStr},
                    mc_rtc::gui::ArrayInput(
                        "Spring", {"cx", "cy", "cz", "fx", "fy", "fz"},
-                       [this, impGainType]() -> const sva::ImpedanceVecd & {
-                         return config_.impGains.at(impGainType).spring().vec();
+                       [this, impGainIdx]() -> const sva::ImpedanceVecd & {
+                         return config_.impGains[impGainIdx].spring().vec();
                        },
-                       [this, impGainType](const Eigen::Vector6d & v) {
-                         config_.impGains.at(impGainType).spring().vec(v);
+                       [this, impGainIdx](const Eigen::Vector6d & v) {
+                         config_.impGains[impGainIdx].spring().vec(v);
                          requireImpGainUpdate_ = true;
                        }));
-    gui.addElement({ctl().name(), config_.name, "ImpedanceGains", impGainType},
+    gui.addElement({ctl().name(), config_.name, "ImpedanceGains", impGainTypeStr},
                    mc_rtc::gui::ArrayInput(
                        "Wrench", {"cx", "cy", "cz", "fx", "fy", "fz"},
-                       [this, impGainType]() -> const sva::ImpedanceVecd & {
-                         return config_.impGains.at(impGainType).wrench().vec();
+                       [this, impGainIdx]() -> const sva::ImpedanceVecd & {
+                         return config_.impGains[impGainIdx].wrench().vec();
                        },
-                       [this, impGainType](const Eigen::Vector6d & v) {
-                         config_.impGains.at(impGainType).wrench().vec(v);
+                       [this, impGainIdx](const Eigen::Vector6d & v) {
+                         config_.impGains[impGainIdx].wrench().vec(v);
                          requireImpGainUpdate_ = true;
                        }));
   }
@@ -238,7 +362,7 @@ void FootManager::addToLogger(mc_rtc::Logger & logger)
   for(const auto & foot : Feet::Both)
   {
     logger.addLogEntry(config_.name + "_impGainType_" + std::to_string(foot), this,
-                       [this, foot]() -> const std::string & { return impGainTypes_.at(foot); });
+                       [this, foot]() { return static_cast<int>(impGainTypes_.at(foot)); });
   }
 }
 
@@ -267,26 +391,57 @@ Footstep FootManager::makeFootstep(const Foot & foot,
 
 bool FootManager::appendFootstep(const Footstep & newFootstep)
 {
-  // Check time of new footstep
-  if(newFootstep.transitStartTime < ctl().t())
+  if(!checkNewFootsteps(footstepQueue_.size(), &newFootstep, 1))
   {
-    mc_rtc::log::error("[FootManager] Ignore a new footstep with past time: {} < {}", newFootstep.transitStartTime,
-                       ctl().t());
     return false;
   }
-  if(!footstepQueue_.empty())
+
+  // Push to the queue
+  footstepQueue_.push_back(newFootstep);
+
+  return true;
+}
+
+bool FootManager::appendFootsteps(const std::vector<Footstep> & newFootsteps)
+{
+  if(!checkNewFootsteps(footstepQueue_.size(), newFootsteps.data(), newFootsteps.size()))
   {
-    const Footstep & lastFootstep = footstepQueue_.back();
-    if(newFootstep.transitStartTime < lastFootstep.transitEndTime)
-    {
-      mc_rtc::log::error("[FootManager] Ignore a new footstep earlier than the last footstep: {} < {}",
-                         newFootstep.transitStartTime, lastFootstep.transitEndTime);
-      return false;
-    }
+    return false;
   }
 
   // Push to the queue
-  footstepQueue_.push_back(newFootstep);
+  footstepQueue_.append(newFootsteps);
+
+  return true;
+}
+
+bool FootManager::replaceFootstepsFrom(size_t idx, const std::vector<Footstep> & newFootsteps)
+{
+  if(idx > footstepQueue_.size())
+  {
+    mc_rtc::log::error("[FootManager] Ignore new footsteps replacing from an index out of the queue: {} > {}", idx,
+                       footstepQueue_.size());
+    return false;
+  }
+  if(idx == footstepQueue_.size())
+  {
+    return appendFootsteps(newFootsteps);
+  }
+  if(swingFootstep() && swingFootstepHandle_ == footstepQueue_.handle(idx))
+  {
+    mc_rtc::log::error("[FootManager] Ignore new footsteps replacing the swinging footstep: {}", idx);
+    return false;
+  }
+  if(!checkNewFootsteps(idx, newFootsteps.data(), newFootsteps.size()))
+  {
+    return false;
+  }
+
+  // Replace footsteps in the queue
+  footstepQueue_.replaceFrom(idx, newFootsteps);
+
+  // Rebuild the gait timeline since the footsteps included in it may have been removed
+  footstepQueueVersion_++;
 
   return true;
 }
@@ -315,64 +470,124 @@ double FootManager::calcRefGroundPosZ(double t, int derivOrder) const
   }
 }
 
-std::unordered_map<Foot, sva::PTransformd> FootManager::calcContactFootPoses(double t) const
+void FootManager::calcRefZmpList(double t0,
+                                 double dt,
+                                 Eigen::Matrix<double, 3, Eigen::Dynamic> & refZmpList,
+                                 int derivOrder) const
+{
+  Eigen::Vector3d offset = Eigen::Vector3d::Zero();
+  if(derivOrder == 0)
+  {
+    offset = overwriteLandingPosLowPass_.eval();
+  }
+  auto cursor = zmpFunc_->cursor(t0);
+  for(int i = 0; i < refZmpList.cols(); i++)
+  {
+    cursor.advanceTo(std::min(t0 + i * dt, zmpFunc_->endTime()));
+    refZmpList.col(i) = (derivOrder == 0 ? cursor.value() : cursor.derivative(derivOrder)) + offset;
+  }
+}
+
+void FootManager::calcRefGroundPosZList(double t0, double dt, Eigen::VectorXd & refGroundPosZList, int derivOrder) const
+{
+  double offset = (derivOrder == 0 ? overwriteLandingPosLowPass_.eval().z() : 0.0);
+  auto cursor = groundPosZFunc_->cursor(t0);
+  for(int i = 0; i < refGroundPosZList.size(); i++)
+  {
+    cursor.advanceTo(std::min(t0 + i * dt, groundPosZFunc_->endTime()));
+    refGroundPosZList(i) = (derivOrder == 0 ? cursor.value() : cursor.derivative(derivOrder)) + offset;
+  }
+}
+
+const FootMap<sva::PTransformd> & FootManager::calcContactFootPoses(double t) const
 {
-  auto it = contactFootPosesList_.upper_bound(t);
-  if(it == contactFootPosesList_.begin())
+  static const FootMap<sva::PTransformd> emptyFootPoses;
+
+  int phaseIdx = gaitTimeline_.phaseIdx(t);
+  if(phaseIdx < 0)
   {
-    return std::unordered_map<Foot, sva::PTransformd>{};
+    return emptyFootPoses;
   }
   else
   {
-    it--;
-    return it->second;
+    return gaitTimeline_.phase(phaseIdx).contactFootPoses;
   }
 }
 
-std::set<Foot> FootManager::getCurrentContactFeet() const
+void FootManager::updateLocalVertexLists()
+{
+  for(const auto & foot : Feet::Both)
+  {
+    auto & localVertexList = localVertexLists_[foot];
+    localVertexList.clear();
+    const auto & surface = ctl().robot().surface(surfaceName(foot));
+    for(const auto & point : surface.points())
+    {
+      // Surface points are represented in body frame, not surface frame
+      localVertexList.push_back((point * surface.X_b_s().inv()).translation());
+    }
+  }
+
+  // Reconstruct the contacts and the support regions in the gait timeline with the new vertices
+  footContacts_.clear();
+  footstepQueueVersion_++;
+}
+
+FootSet FootManager::getCurrentContactFeet() const
 {
   if(supportPhase_ == SupportPhase::DoubleSupport)
   {
-    return Feet::Both;
+    return FootSet{Foot::Left, Foot::Right};
   }
   else
   {
     if(config_.enableWrenchDistForTouchDownFoot && touchDown_)
     {
-      return Feet::Both;
+      return FootSet{Foot::Left, Foot::Right};
     }
     else
     {
       if(supportPhase_ == SupportPhase::LeftSupport)
       {
-        return std::set<Foot>{Foot::Left};
+        return FootSet{Foot::Left};
       }
       else // if(supportPhase_ == SupportPhase::RightSupport)
       {
-        return std::set<Foot>{Foot::Right};
+        return FootSet{Foot::Right};
       }
     }
   }
 }
 
-std::unordered_map<Foot, std::shared_ptr<Contact>> FootManager::calcCurrentContactList() const
+const FootMap<std::shared_ptr<Contact>> & FootManager::calcCurrentContactList()
 {
-  // Set contactList
-  std::unordered_map<Foot, std::shared_ptr<Contact>> contactList;
-  for(const auto & foot : getCurrentContactFeet())
+  const auto & contactFeet = getCurrentContactFeet();
+
+  for(const auto & foot : Feet::Both)
   {
-    std::vector<Eigen::Vector3d> localVertexList;
-    const auto & surface = ctl().robot().surface(surfaceName(foot));
-    for(const auto & point : surface.points())
+    if(contactFeet.count(foot) == 0)
     {
-      // Surface points are represented in body frame, not surface frame
-      localVertexList.push_back((point * surface.X_b_s().inv()).translation());
+      currentContactList_.erase(foot);
+      continue;
+    }
+
+    // Construct the contact only for the first time, when the friction coefficient is changed, or when the foot
+    // surfaces are updated
+    auto contactIt = footContacts_.find(foot);
+    if(contactIt == footContacts_.end() || contactIt->second->fricCoeff() != config_.fricCoeff)
+    {
+      footContacts_[foot] = std::make_shared<Contact>(std::to_string(foot), config_.fricCoeff, localVertexList(foot),
+                                                      targetFootPoses_.at(foot));
+    }
+    else
+    {
+      contactIt->second->updatePose(targetFootPoses_.at(foot));
     }
-    contactList.emplace(foot, std::make_shared<Contact>(std::to_string(foot), config_.fricCoeff, localVertexList,
-                                                        targetFootPoses_.at(foot)));
+
+    currentContactList_[foot] = footContacts_.at(foot);
   }
 
-  return contactList;
+  return currentContactList_;
 }
 
 double FootManager::leftFootSupportRatio() const
@@ -414,7 +629,7 @@ Eigen::Vector3d FootManager::calcZmpWithOffset(const Foot & foot, const sva::PTr
   return (sva::PTransformd(zmpOffset) * footPose).translation();
 }
 
-Eigen::Vector3d FootManager::calcZmpWithOffset(const std::unordered_map<Foot, sva::PTransformd> & footPoses) const
+Eigen::Vector3d FootManager::calcZmpWithOffset(const FootMap<sva::PTransformd> & footPoses) const
 {
   if(footPoses.size() == 0)
   {
@@ -433,6 +648,41 @@ Eigen::Vector3d FootManager::calcZmpWithOffset(const std::unordered_map<Foot, sv
   }
 }
 
+bool FootManager::checkNewFootsteps(size_t idx, const Footstep * newFootsteps, size_t newFootstepNum) const
+{
+  if(newFootstepNum > footstepQueue_.capacity() - idx)
+  {
+    mc_rtc::log::error("[FootManager] Ignore new footsteps because the footstep queue is full: {} + {} > {}", idx,
+                       newFootstepNum, footstepQueue_.capacity());
+    return false;
+  }
+
+  for(size_t i = 0; i < newFootstepNum; i++)
+  {
+    const Footstep & newFootstep = newFootsteps[i];
+
+    // Check time of new footstep
+    if(newFootstep.transitStartTime < ctl().t())
+    {
+      mc_rtc::log::error("[FootManager] Ignore a new footstep with past time: {} < {}", newFootstep.transitStartTime,
+                         ctl().t());
+      return false;
+    }
+    if(i > 0 || idx > 0)
+    {
+      const Footstep & lastFootstep = (i > 0 ? newFootsteps[i - 1] : footstepQueue_[idx - 1]);
+      if(newFootstep.transitStartTime < lastFootstep.transitEndTime)
+      {
+        mc_rtc::log::error("[FootManager] Ignore a new footstep earlier than the last footstep: {} < {}",
+                           newFootstep.transitStartTime, lastFootstep.transitEndTime);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 void FootManager::updateFootTraj()
 {
   // Disable hold mode by default
@@ -446,132 +696,74 @@ void FootManager::updateFootTraj()
   {
     prevFootstep_ = std::make_shared<Footstep>(footstepQueue_.front());
     footstepQueue_.pop_front();
+    if(zmpTrajFootstepNum_ > 0)
+    {
+      zmpTrajFootstepNum_--;
+    }
   }
 
   if(!footstepQueue_.empty() && footstepQueue_.front().swingStartTime <= ctl().t()
      && ctl().t() <= footstepQueue_.front().swingEndTime)
   {
     // Single support phase
-    if(swingFootstep_)
+    if(swingFootstep())
     {
-      // Check if swingFootstep_ is consistent
-      if(swingFootstep_ != &(footstepQueue_.front()))
+      // Check if swingFootstep() is consistent
+      if(swingFootstepHandle_ != footstepQueue_.handle(0))
       {
         mc_rtc::log::error_and_throw("[FootManager] Swing footstep is not consistent.");
       }
     }
     else
     {
-      // Set swingFootstep_
-      swingFootstep_ = &(footstepQueue_.front());
+      // Set swingFootstepHandle_
+      swingFootstepHandle_ = footstepQueue_.handle(0);
+
+      // Enable hold mode to prevent IK target pose from jumping
+      // https://github.com/jrl-umi3218/mc_rtc/pull/143
+      ctl().footTasks_.at(swingFootstep()->foot)->hold(true);
 
-      // Set swingPosFunc_ and swingRotFunc_
+      // Set swingPosFunc_, swingRotFunc_, and baseYawFunc_
       {
-        // Enable hold mode to prevent IK target pose from jumping
-        // https://github.com/jrl-umi3218/mc_rtc/pull/143
-        ctl().footTasks_.at(swingFootstep_->foot)->hold(true);
+        const sva::PTransformd & swingStartPose = ctl().robot().surfacePose(surfaceName(swingFootstep()->foot));
+        std::shared_ptr<SwingTraj> swingTraj = fetchSwingTraj(swingStartPose);
 
-        const sva::PTransformd & swingStartPose = ctl().robot().surfacePose(surfaceName(swingFootstep_->foot));
-        sva::PTransformd swingGoalPose = swingFootstep_->pose;
-        if(config_.overwriteLandingPose && prevFootstep_)
+        // Correct the precomputed trajectory for the actual swing start pose
+        // The trajectory calculated in place already starts from the actual pose and has no sensitivity functions
+        if(swingTraj->posSensitivityFuncs[0])
         {
-          sva::PTransformd swingRelPose = swingFootstep_->pose * prevFootstep_->pose.inv();
-          swingGoalPose = swingRelPose * targetFootPoses_.at(prevFootstep_->foot);
+          // Correct the position trajectory
+          const std::array<Eigen::Vector3d, 3> & startWaypoints =
+              calcSwingStartWaypoints(swingTraj->footstep, swingStartPose, swingTraj->goalPose);
+          for(size_t i = 0; i < startWaypoints.size(); i++)
+          {
+            swingTraj->posFunc->addScaledSegments(*swingTraj->posSensitivityFuncs[i],
+                                                  startWaypoints[i] - swingTraj->startWaypoints[i]);
+          }
+
+          // Correct the rotation trajectory
+          double withdrawEndTime =
+              swingTraj->footstep.swingStartTime
+              + swingTraj->footstep.config.withdrawDurationRatio
+                    * (swingTraj->footstep.swingEndTime - swingTraj->footstep.swingStartTime);
+          for(size_t i = 0;
+              i < swingTraj->rotFunc->times().size() && swingTraj->rotFunc->times()[i] <= withdrawEndTime; i++)
+          {
+            swingTraj->rotFunc->setPointValue(i, swingStartPose.rotation().transpose());
+          }
         }
-        double withdrawDuration = swingFootstep_->config.withdrawDurationRatio
-                                  * (swingFootstep_->swingEndTime - swingFootstep_->swingStartTime);
-        double approachDuration = swingFootstep_->config.approachDurationRatio
-                                  * (swingFootstep_->swingEndTime - swingFootstep_->swingStartTime);
-
-        BoundaryConstraint<Eigen::Vector3d> zeroVelBC(BoundaryConstraintType::Velocity, Eigen::Vector3d::Zero());
-        BoundaryConstraint<Eigen::Vector3d> zeroAccelBC(BoundaryConstraintType::Acceleration, Eigen::Vector3d::Zero());
-
-        // Spline to withdraw foot
-        // Pos
-        std::map<double, Eigen::Vector3d> withdrawPosWaypoints = {
-            {swingFootstep_->swingStartTime, swingStartPose.translation()},
-            {swingFootstep_->swingStartTime + withdrawDuration,
-             (sva::PTransformd(swingFootstep_->config.withdrawOffset) * swingStartPose).translation()}};
-        auto withdrawPosSpline =
-            std::make_shared<CubicSpline<Eigen::Vector3d>>(3, withdrawPosWaypoints, zeroVelBC, zeroAccelBC);
-        withdrawPosSpline->calcCoeff();
-        swingPosFunc_->appendFunc(swingFootstep_->swingStartTime + withdrawDuration, withdrawPosSpline);
-        // Rot
-        swingRotFunc_->appendPoint(
-            std::make_pair(swingFootstep_->swingStartTime, swingStartPose.rotation().transpose()));
-        swingRotFunc_->appendPoint(
-            std::make_pair(swingFootstep_->swingStartTime + withdrawDuration, swingStartPose.rotation().transpose()));
-
-        // Spline to approach foot
-        // Pos
-        std::map<double, Eigen::Vector3d> approachPosWaypoints = {
-            {swingFootstep_->swingEndTime - approachDuration,
-             (sva::PTransformd(swingFootstep_->config.approachOffset) * swingGoalPose).translation()},
-            {swingFootstep_->swingEndTime, swingGoalPose.translation()}};
-        auto approachPosSpline =
-            std::make_shared<CubicSpline<Eigen::Vector3d>>(3, approachPosWaypoints, zeroAccelBC, zeroVelBC);
-        approachPosSpline->calcCoeff();
-        swingPosFunc_->appendFunc(swingFootstep_->swingEndTime, approachPosSpline);
-        // Rot
-        swingRotFunc_->appendPoint(std::make_pair(swingFootstep_->swingEndTime - approachDuration,
-                                                  swingFootstep_->pose.rotation().transpose()));
-        swingRotFunc_->appendPoint(
-            std::make_pair(swingFootstep_->swingEndTime, swingFootstep_->pose.rotation().transpose()));
-
-        // Spline to swing foot
-        // Pos
-        std::map<double, Eigen::Vector3d> swingPosWaypoints = {
-            *withdrawPosWaypoints.rbegin(),
-            {0.5 * (swingFootstep_->swingStartTime + swingFootstep_->swingEndTime),
-             (sva::PTransformd(swingFootstep_->config.swingOffset)
-              * sva::interpolate(swingStartPose, swingGoalPose, 0.5))
-                 .translation()},
-            *approachPosWaypoints.begin()};
-        auto swingPosSpline = std::make_shared<CubicSpline<Eigen::Vector3d>>(
-            3, swingPosWaypoints,
-            BoundaryConstraint<Eigen::Vector3d>(
-                BoundaryConstraintType::Velocity,
-                withdrawPosSpline->derivative(swingFootstep_->swingStartTime + withdrawDuration, 1)),
-            BoundaryConstraint<Eigen::Vector3d>(
-                BoundaryConstraintType::Velocity,
-                approachPosSpline->derivative(swingFootstep_->swingEndTime - approachDuration, 1)));
-        swingPosSpline->calcCoeff();
-        swingPosFunc_->appendFunc(swingFootstep_->swingEndTime - approachDuration, swingPosSpline);
-        // Rot
-        swingRotFunc_->calcCoeff();
-      }
 
-      // Set baseYawFunc_
-      {
-        double swingStartBaseYaw =
-            mc_rbdyn::rpyFromMat(interpolate<Eigen::Matrix3d>(targetFootPoses_.at(Foot::Left).rotation().transpose(),
-                                                              targetFootPoses_.at(Foot::Right).rotation().transpose(),
-                                                              0.5)
-                                     .transpose())
-                .z();
-        baseYawFunc_->appendPoint(
-            std::make_pair(swingFootstep_->swingStartTime,
-                           Eigen::AngleAxisd(swingStartBaseYaw, Eigen::Vector3d::UnitZ()).toRotationMatrix()));
-
-        double swingEndBaseYaw =
-            mc_rbdyn::rpyFromMat(interpolate<Eigen::Matrix3d>(
-                                     swingFootstep_->pose.rotation().transpose(),
-                                     targetFootPoses_.at(opposite(swingFootstep_->foot)).rotation().transpose(), 0.5)
-                                     .transpose())
-                .z();
-        baseYawFunc_->appendPoint(
-            std::make_pair(swingFootstep_->swingEndTime,
-                           Eigen::AngleAxisd(swingEndBaseYaw, Eigen::Vector3d::UnitZ()).toRotationMatrix()));
-
-        baseYawFunc_->calcCoeff();
+        swingPosFunc_ = swingTraj->posFunc;
+        swingRotFunc_ = swingTraj->rotFunc;
+        baseYawFunc_ = swingTraj->baseYawFunc;
       }
 
       // Set supportPhase_
-      if(swingFootstep_->foot == Foot::Left)
+      if(swingFootstep()->foot == Foot::Left)
       {
         supportPhase_ = SupportPhase::RightSupport;
       }
-      else // if(swingFootstep_->foot == Foot::Right)
+      else // if(swingFootstep()->foot == Foot::Right)
       {
         supportPhase_ = SupportPhase::LeftSupport;
       }
@@ -580,12 +772,11 @@ void FootManager::updateFootTraj()
     // Update target
     if(!(config_.stopSwingTrajForTouchDownFoot && touchDown_))
     {
-      targetFootPoses_.at(swingFootstep_->foot) =
-          sva::PTransformd((*swingRotFunc_)(ctl().t()).transpose(), (*swingPosFunc_)(ctl().t()));
-      targetFootVels_.at(swingFootstep_->foot) =
-          sva::MotionVecd(swingRotFunc_->derivative(ctl().t(), 1), swingPosFunc_->derivative(ctl().t(), 1));
-      targetFootAccels_.at(swingFootstep_->foot) =
-          sva::MotionVecd(swingRotFunc_->derivative(ctl().t(), 2), swingPosFunc_->derivative(ctl().t(), 2));
+      const auto swingPos = swingPosFunc_->evalAll(ctl().t());
+      const auto swingRot = swingRotFunc_->evalAll(ctl().t());
+      targetFootPoses_.at(swingFootstep()->foot) = sva::PTransformd(swingRot.value.transpose(), swingPos.value);
+      targetFootVels_.at(swingFootstep()->foot) = sva::MotionVecd(swingRot.vel, swingPos.vel);
+      targetFootAccels_.at(swingFootstep()->foot) = sva::MotionVecd(swingRot.accel, swingPos.accel);
     }
 
     // Update touchDown_
@@ -595,32 +786,33 @@ void FootManager::updateFootTraj()
 
       if(config_.stopSwingTrajForTouchDownFoot)
       {
-        targetFootVels_.at(swingFootstep_->foot) = sva::MotionVecd::Zero();
-        targetFootAccels_.at(swingFootstep_->foot) = sva::MotionVecd::Zero();
+        targetFootVels_.at(swingFootstep()->foot) = sva::MotionVecd::Zero();
+        targetFootAccels_.at(swingFootstep()->foot) = sva::MotionVecd::Zero();
       }
     }
   }
   else
   {
     // Double support phase
-    if(swingFootstep_)
+    if(swingFootstep())
     {
       // Update target
       if(!(config_.keepSupportFootPoseForTouchDownFoot && touchDown_))
       {
-        targetFootPoses_.at(swingFootstep_->foot) = sva::PTransformd(
-            (*swingRotFunc_)(swingFootstep_->swingEndTime).transpose(), (*swingPosFunc_)(swingFootstep_->swingEndTime));
-        targetFootVels_.at(swingFootstep_->foot) = sva::MotionVecd::Zero();
-        targetFootAccels_.at(swingFootstep_->foot) = sva::MotionVecd::Zero();
+        targetFootPoses_.at(swingFootstep()->foot) =
+            sva::PTransformd((*swingRotFunc_)(swingFootstep()->swingEndTime).transpose(),
+                             (*swingPosFunc_)(swingFootstep()->swingEndTime));
+        targetFootVels_.at(swingFootstep()->foot) = sva::MotionVecd::Zero();
+        targetFootAccels_.at(swingFootstep()->foot) = sva::MotionVecd::Zero();
       }
 
-      lastDoubleSupportFootPoses_.at(swingFootstep_->foot) = swingFootstep_->pose;
+      lastDoubleSupportFootPoses_.at(swingFootstep()->foot) = swingFootstep()->pose;
 
       // Set supportPhase_
       supportPhase_ = SupportPhase::DoubleSupport;
 
       // Clear swingPosFunc_ and swingRotFunc_
-      swingPosFunc_->clearFuncs();
+      swingPosFunc_->clearSegments();
       swingRotFunc_->clearPoints();
 
       // Clear baseYawFunc_
@@ -629,8 +821,14 @@ void FootManager::updateFootTraj()
       // Clear touchDown_
       touchDown_ = false;
 
-      // Clear swingFootstep_
-      swingFootstep_ = nullptr;
+      // Clear swingFootstepHandle_
+      swingFootstepHandle_ = {};
+    }
+
+    // Request the swing trajectory of the next footstep
+    if(config_.precomputeSwingTraj)
+    {
+      requestSwingTraj();
     }
   }
 
@@ -645,41 +843,29 @@ void FootManager::updateFootTraj()
   }
 
   // Update impGainTypes_ and requireImpGainUpdate_
-  std::unordered_map<Foot, std::string> newImpGainTypes;
   const auto & contactFeet = getCurrentContactFeet();
-  if(contactFeet.size() == 1)
-  {
-    newImpGainTypes.emplace(*(contactFeet.cbegin()), "singleSupport");
-    newImpGainTypes.emplace(opposite(*(contactFeet.cbegin())), "swing");
-  }
-  else // if(contactFeet.size() == 2)
-  {
-    for(const auto & foot : Feet::Both)
-    {
-      newImpGainTypes.emplace(foot, "doubleSupport");
-    }
-  }
   for(const auto & foot : Feet::Both)
   {
-    if(requireImpGainUpdate_)
+    ImpGainType newImpGainType = ImpGainType::DoubleSupport;
+    if(contactFeet.size() == 1)
     {
-      break;
+      newImpGainType = (contactFeet.count(foot) ? ImpGainType::SingleSupport : ImpGainType::Swing);
     }
-    if(impGainTypes_.at(foot) != newImpGainTypes.at(foot))
+    if(impGainTypes_.at(foot) != newImpGainType)
     {
+      impGainTypes_.at(foot) = newImpGainType;
       requireImpGainUpdate_ = true;
     }
   }
-  impGainTypes_ = newImpGainTypes;
 
-  // Set impedance gains of foot tasks
+  // Set impedance gains of foot tasks only when the gain types or gains are changed
   if(requireImpGainUpdate_)
   {
     requireImpGainUpdate_ = false;
 
     for(const auto & foot : Feet::Both)
     {
-      ctl().footTasks_.at(foot)->gains() = config_.impGains.at(impGainTypes_.at(foot));
+      ctl().footTasks_.at(foot)->gains() = config_.impGains[static_cast<size_t>(impGainTypes_.at(foot))];
     }
   }
 
@@ -694,87 +880,311 @@ void FootManager::updateFootTraj()
   }
   else
   {
-    ctl().baseOriTask_->orientation((*baseYawFunc_)(ctl().t()).transpose());
-    ctl().baseOriTask_->refVel(baseYawFunc_->derivative(ctl().t(), 1));
-    ctl().baseOriTask_->refAccel(baseYawFunc_->derivative(ctl().t(), 2));
+    const auto baseYaw = baseYawFunc_->evalAll(ctl().t());
+    ctl().baseOriTask_->orientation(baseYaw.value.transpose());
+    ctl().baseOriTask_->refVel(baseYaw.vel);
+    ctl().baseOriTask_->refAccel(baseYaw.accel);
   }
 
   // Update footstep visualization
-  std::vector<std::vector<Eigen::Vector3d>> footstepPolygonList;
-  for(const auto & footstep : footstepQueue_)
+  updateFootstepMarkers();
+}
+
+void FootManager::updateFootstepMarkers()
+{
+  if(footstepMarkerQueueRevision_ == footstepQueue_.revision() && footstepMarkerQueueVersion_ == footstepQueueVersion_)
   {
-    std::vector<Eigen::Vector3d> footstepPolygon;
-    const auto & surface = ctl().robot().surface(surfaceName(footstep.foot));
-    for(const auto & point : surface.points())
+    return;
+  }
+  if(ctl().t() < footstepMarkerUpdateTime_ + config_.footstepMarkerUpdatePeriod)
+  {
+    return;
+  }
+
+  // Write to the back buffer, reusing the allocated vectors
+  auto & footstepPolygonList = footstepMarkerBuffers_[footstepMarkerBackIdx_];
+  footstepPolygonList.resize(footstepQueue_.size());
+  for(size_t i = 0; i < footstepQueue_.size(); i++)
+  {
+    const Footstep & footstep = footstepQueue_[i];
+    const auto & localVertexList = this->localVertexList(footstep.foot);
+    auto & footstepPolygon = footstepPolygonList[i];
+    footstepPolygon.resize(localVertexList.size());
+    for(size_t j = 0; j < localVertexList.size(); j++)
     {
-      // Surface points are represented in body frame, not surface frame
-      footstepPolygon.push_back((point * surface.X_b_s().inv() * footstep.pose).translation());
+      // Equivalent to (sva::PTransformd(localVertexList[j]) * footstep.pose).translation()
+      footstepPolygon[j] = footstep.pose.translation() + footstep.pose.rotation().transpose() * localVertexList[j];
     }
-    footstepPolygonList.push_back(footstepPolygon);
   }
+  // Publish the back buffer as the fresh middle buffer and take over the previous middle buffer
+  footstepMarkerBackIdx_ =
+      footstepMarkerMiddleIdx_.exchange(footstepMarkerBackIdx_ | footstepMarkerFreshBit, std::memory_order_acq_rel)
+      & ~footstepMarkerFreshBit;
+
+  footstepMarkerQueueRevision_ = footstepQueue_.revision();
+  footstepMarkerQueueVersion_ = footstepQueueVersion_;
+  footstepMarkerUpdateTime_ = ctl().t();
+}
 
-  ctl().gui()->removeCategory({ctl().name(), config_.name, "FootstepMarker"});
-  ctl().gui()->addElement({ctl().name(), config_.name, "FootstepMarker"},
-                          mc_rtc::gui::Polygon("Footstep", {mc_rtc::gui::Color::Blue, 0.02},
-                                               [footstepPolygonList]() { return footstepPolygonList; }));
+bool FootManager::SwingTraj::isCalculatedFrom(const FootstepQueue::Handle & _handle,
+                                              const sva::PTransformd & _goalPose,
+                                              const FootMap<sva::PTransformd> & _startTargetFootPoses) const
+{
+  if(handle != _handle || goalPose != _goalPose)
+  {
+    return false;
+  }
+  for(const auto & foot : Feet::Both)
+  {
+    if(startTargetFootPoses.at(foot) != _startTargetFootPoses.at(foot))
+    {
+      return false;
+    }
+  }
+  return true;
 }
 
-void FootManager::updateZmpTraj()
+sva::PTransformd FootManager::calcSwingGoalPose(const Footstep & footstep) const
 {
-  zmpFunc_->clearPoints();
-  groundPosZFunc_->clearPoints();
-  contactFootPosesList_.clear();
+  if(config_.overwriteLandingPose && prevFootstep_)
+  {
+    sva::PTransformd swingRelPose = footstep.pose * prevFootstep_->pose.inv();
+    return swingRelPose * targetFootPoses_.at(prevFootstep_->foot);
+  }
+  return footstep.pose;
+}
 
-  std::unordered_map<Foot, sva::PTransformd> footPoses = lastDoubleSupportFootPoses_;
+void FootManager::calcSwingTraj(SwingTraj & swingTraj, bool withSensitivity)
+{
+  const Footstep & footstep = swingTraj.footstep;
+  double withdrawDuration = footstep.config.withdrawDurationRatio * (footstep.swingEndTime - footstep.swingStartTime);
+  double approachDuration = footstep.config.approachDurationRatio * (footstep.swingEndTime - footstep.swingStartTime);
 
-  auto calcFootMidposZ = [](const std::unordered_map<Foot, sva::PTransformd> & _footPoses) {
-    return 0.5 * (_footPoses.at(Foot::Left).translation().z() + _footPoses.at(Foot::Right).translation().z());
-  };
+  // Set posFunc and posSensitivityFuncs
+  {
+    swingTraj.startWaypoints = calcSwingStartWaypoints(footstep, swingTraj.startPose, swingTraj.goalPose);
+    std::array<Eigen::Vector3d, 2> endWaypoints = {
+        (sva::PTransformd(footstep.config.approachOffset) * swingTraj.goalPose).translation(),
+        swingTraj.goalPose.translation()};
+    swingTraj.posFunc = makeSwingPosFunc(footstep, withdrawDuration, approachDuration, swingTraj.startWaypoints,
+                                         endWaypoints);
+
+    // Since the position function is linear in the waypoints, the sensitivity to each waypoint is the function whose
+    // waypoints are zero except for that waypoint
+    for(size_t i = 0; withSensitivity && i < swingTraj.posSensitivityFuncs.size(); i++)
+    {
+      std::array<Eigen::Vector3d, 3> unitStartWaypoints = {Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero(),
+                                                           Eigen::Vector3d::Zero()};
+      unitStartWaypoints[i].setOnes();
+      swingTraj.posSensitivityFuncs[i] =
+          makeSwingPosFunc(footstep, withdrawDuration, approachDuration, unitStartWaypoints,
+                           {Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero()});
+    }
+  }
 
-  if(footstepQueue_.empty() || ctl().t() < footstepQueue_.front().transitStartTime)
+  // Set rotFunc
   {
-    // Set initial point
-    zmpFunc_->appendPoint(std::make_pair(ctl().t(), calcZmpWithOffset(footPoses)));
-    groundPosZFunc_->appendPoint(std::make_pair(ctl().t(), calcFootMidposZ(footPoses)));
-    contactFootPosesList_.emplace(ctl().t(), footPoses);
+    swingTraj.rotFunc = std::make_shared<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>();
+    swingTraj.rotFunc->appendPoint(std::make_pair(footstep.swingStartTime, swingTraj.startPose.rotation().transpose()));
+    swingTraj.rotFunc->appendPoint(
+        std::make_pair(footstep.swingStartTime + withdrawDuration, swingTraj.startPose.rotation().transpose()));
+    swingTraj.rotFunc->appendPoint(
+        std::make_pair(footstep.swingEndTime - approachDuration, footstep.pose.rotation().transpose()));
+    swingTraj.rotFunc->appendPoint(std::make_pair(footstep.swingEndTime, footstep.pose.rotation().transpose()));
+    swingTraj.rotFunc->calcCoeff();
   }
 
-  for(const auto & footstep : footstepQueue_)
+  // Set baseYawFunc
   {
-    Foot supportFoot = opposite(footstep.foot);
-    Eigen::Vector3d supportFootZmp = calcZmpWithOffset(supportFoot, footPoses.at(supportFoot));
+    const auto & startTargetFootPoses = swingTraj.startTargetFootPoses;
+    swingTraj.baseYawFunc = std::make_shared<CubicInterpolator<Eigen::Matrix3d, Eigen::Vector3d>>();
+
+    double swingStartBaseYaw =
+        mc_rbdyn::rpyFromMat(interpolate<Eigen::Matrix3d>(startTargetFootPoses.at(Foot::Left).rotation().transpose(),
+                                                          startTargetFootPoses.at(Foot::Right).rotation().transpose(),
+                                                          0.5)
+                                 .transpose())
+            .z();
+    swingTraj.baseYawFunc->appendPoint(
+        std::make_pair(footstep.swingStartTime,
+                       Eigen::AngleAxisd(swingStartBaseYaw, Eigen::Vector3d::UnitZ()).toRotationMatrix()));
+
+    double swingEndBaseYaw =
+        mc_rbdyn::rpyFromMat(interpolate<Eigen::Matrix3d>(
+                                 footstep.pose.rotation().transpose(),
+                                 startTargetFootPoses.at(opposite(footstep.foot)).rotation().transpose(), 0.5)
+                                 .transpose())
+            .z();
+    swingTraj.baseYawFunc->appendPoint(
+        std::make_pair(footstep.swingEndTime,
+                       Eigen::AngleAxisd(swingEndBaseYaw, Eigen::Vector3d::UnitZ()).toRotationMatrix()));
+
+    swingTraj.baseYawFunc->calcCoeff();
+  }
+}
 
-    zmpFunc_->appendPoint(std::make_pair(footstep.transitStartTime, calcZmpWithOffset(footPoses)));
-    groundPosZFunc_->appendPoint(std::make_pair(footstep.transitStartTime, calcFootMidposZ(footPoses)));
-    contactFootPosesList_.emplace(footstep.transitStartTime, footPoses);
+void FootManager::requestSwingTraj()
+{
+  if(footstepQueue_.empty() || footstepQueue_.front().swingStartTime <= ctl().t())
+  {
+    return;
+  }
 
-    zmpFunc_->appendPoint(std::make_pair(footstep.swingStartTime, supportFootZmp));
-    groundPosZFunc_->appendPoint(std::make_pair(footstep.swingStartTime, calcFootMidposZ(footPoses)));
-    contactFootPosesList_.emplace(footstep.swingStartTime,
-                                  std::unordered_map<Foot, sva::PTransformd>{{supportFoot, footPoses.at(supportFoot)}});
+  const Footstep & footstep = footstepQueue_.front();
+  FootstepQueue::Handle handle = footstepQueue_.handle(0);
+  sva::PTransformd goalPose = calcSwingGoalPose(footstep);
+  if(lastSwingTrajRequest_ && lastSwingTrajRequest_->isCalculatedFrom(handle, goalPose, targetFootPoses_))
+  {
+    return;
+  }
 
-    // Update footPoses
-    footPoses.at(footstep.foot) = footstep.pose;
+  std::unique_lock<std::mutex> lock(swingTrajMutex_, std::try_to_lock);
+  if(!lock.owns_lock())
+  {
+    // Retry in the next control cycle
+    return;
+  }
 
-    zmpFunc_->appendPoint(std::make_pair(footstep.swingEndTime, supportFootZmp));
-    groundPosZFunc_->appendPoint(std::make_pair(footstep.swingEndTime, calcFootMidposZ(footPoses)));
-    contactFootPosesList_.emplace(footstep.swingEndTime, footPoses);
+  // Assume that the swing foot starts from the current target pose
+  swingTrajRequest_ = std::make_shared<SwingTraj>(handle, footstep);
+  swingTrajRequest_->startPose = targetFootPoses_.at(footstep.foot);
+  swingTrajRequest_->goalPose = goalPose;
+  swingTrajRequest_->startTargetFootPoses = targetFootPoses_;
+  lastSwingTrajRequest_ = swingTrajRequest_;
+  lock.unlock();
+  swingTrajCond_.notify_one();
+}
 
-    groundPosZFunc_->appendPoint(std::make_pair(footstep.transitEndTime, calcFootMidposZ(footPoses)));
-    zmpFunc_->appendPoint(std::make_pair(footstep.transitEndTime, calcZmpWithOffset(footPoses)));
-    contactFootPosesList_.emplace(footstep.transitEndTime, footPoses);
+std::shared_ptr<FootManager::SwingTraj> FootManager::fetchSwingTraj(const sva::PTransformd & swingStartPose)
+{
+  const Footstep & footstep = *swingFootstep();
+  sva::PTransformd goalPose = calcSwingGoalPose(footstep);
 
-    if(ctl().t() + config_.zmpHorizon <= footstep.transitEndTime)
+  std::shared_ptr<SwingTraj> swingTraj;
+  {
+    std::unique_lock<std::mutex> lock(swingTrajMutex_, std::try_to_lock);
+    if(lock.owns_lock())
     {
-      break;
+      swingTraj = std::move(swingTrajResult_);
     }
   }
+  lastSwingTrajRequest_.reset();
+
+  if(swingTraj && swingTraj->isCalculatedFrom(swingFootstepHandle_, goalPose, targetFootPoses_))
+  {
+    return swingTraj;
+  }
+
+  // Calculate in place from the actual swing start pose if the precomputed trajectory is not available
+  swingTraj = std::make_shared<SwingTraj>(swingFootstepHandle_, footstep);
+  swingTraj->startPose = swingStartPose;
+  swingTraj->goalPose = goalPose;
+  swingTraj->startTargetFootPoses = targetFootPoses_;
+  calcSwingTraj(*swingTraj, false);
+  return swingTraj;
+}
+
+void FootManager::startSwingTrajThread()
+{
+  if(swingTrajThreadRunning_)
+  {
+    return;
+  }
+
+  swingTrajThreadRunning_ = true;
+  swingTrajThread_ = std::thread(&FootManager::swingTrajThread, this);
+}
+
+void FootManager::stopSwingTrajThread()
+{
+  {
+    std::lock_guard<std::mutex> lock(swingTrajMutex_);
+    swingTrajThreadRunning_ = false;
+  }
+  swingTrajCond_.notify_one();
+  if(swingTrajThread_.joinable())
+  {
+    swingTrajThread_.join();
+  }
+
+  swingTrajRequest_.reset();
+  swingTrajResult_.reset();
+  lastSwingTrajRequest_.reset();
+}
+
+void FootManager::swingTrajThread()
+{
+  while(true)
+  {
+    std::shared_ptr<SwingTraj> swingTraj;
+    {
+      std::unique_lock<std::mutex> lock(swingTrajMutex_);
+      swingTrajCond_.wait(lock, [this]() { return swingTrajRequest_ || !swingTrajThreadRunning_; });
+      if(!swingTrajThreadRunning_)
+      {
+        break;
+      }
+      swingTraj = std::move(swingTrajRequest_);
+    }
+
+    calcSwingTraj(*swingTraj);
+
+    // The previous result is released in this thread
+    std::lock_guard<std::mutex> lock(swingTrajMutex_);
+    std::swap(swingTrajResult_, swingTraj);
+  }
+}
+
+void FootManager::updateZmpTraj()
+{
+  if(footstepQueue_.empty() || zmpTrajFootstepNum_ == 0 || zmpTrajVersion_ != footstepQueueVersion_)
+  {
+    // Rebuild the whole timeline
+    gaitTimeline_.clear();
+    zmpFunc_->clearPoints();
+    groundPosZFunc_->clearPoints();
+
+    zmpTrajVersion_ = footstepQueueVersion_;
+    zmpTrajFootstepNum_ = 0;
+    zmpTrajEndFootPoses_ = lastDoubleSupportFootPoses_;
+  }
+  else
+  {
+    // Remove the phases before the first footstep (i.e., the phases of finished footsteps and the previous initial
+    // phase) and the phases after the last included footstep (i.e., the previous terminal phase)
+    // The points of ZMP and ground Z position functions are removed in the same way to keep them in step
+    double startTime = footstepQueue_.front().transitStartTime;
+    double endTime = footstepQueue_[zmpTrajFootstepNum_ - 1].transitEndTime;
+    gaitTimeline_.removePhasesBefore(startTime);
+    gaitTimeline_.removePhasesAfter(endTime);
+    zmpFunc_->removePointsBefore(startTime);
+    zmpFunc_->removePointsAfter(endTime);
+    groundPosZFunc_->removePointsBefore(startTime);
+    groundPosZFunc_->removePointsAfter(endTime);
+  }
+
+  if(footstepQueue_.empty() || ctl().t() < footstepQueue_.front().transitStartTime)
+  {
+    // Set initial phase
+    // Since the footsteps are not finished, lastDoubleSupportFootPoses_ corresponds to the start of the first footstep
+    appendGaitPhase(ctl().t(), calcZmpWithOffset(lastDoubleSupportFootPoses_),
+                    calcFootMidposZ(lastDoubleSupportFootPoses_), lastDoubleSupportFootPoses_);
+  }
+
+  // Append the footsteps entering the horizon
+  while(zmpTrajFootstepNum_ < footstepQueue_.size()
+        && (zmpTrajFootstepNum_ == 0
+            || footstepQueue_[zmpTrajFootstepNum_ - 1].transitEndTime < ctl().t() + config_.zmpHorizon))
+  {
+    appendZmpTrajFootstep(footstepQueue_[zmpTrajFootstepNum_]);
+    zmpTrajFootstepNum_++;
+  }
 
   if(footstepQueue_.empty() || footstepQueue_.back().transitEndTime < ctl().t() + config_.zmpHorizon)
   {
-    // Set terminal point
-    zmpFunc_->appendPoint(std::make_pair(ctl().t() + config_.zmpHorizon, calcZmpWithOffset(footPoses)));
-    groundPosZFunc_->appendPoint(std::make_pair(ctl().t() + config_.zmpHorizon, calcFootMidposZ(footPoses)));
+    // Set terminal phase
+    appendGaitPhase(ctl().t() + config_.zmpHorizon, calcZmpWithOffset(zmpTrajEndFootPoses_),
+                    calcFootMidposZ(zmpTrajEndFootPoses_), zmpTrajEndFootPoses_);
   }
 
   zmpFunc_->calcCoeff();
@@ -808,6 +1218,54 @@ void FootManager::updateZmpTraj()
   }
 }
 
+void FootManager::appendZmpTrajFootstep(const Footstep & footstep)
+{
+  FootMap<sva::PTransformd> & footPoses = zmpTrajEndFootPoses_;
+
+  Foot supportFoot = opposite(footstep.foot);
+  Eigen::Vector3d supportFootZmp = calcZmpWithOffset(supportFoot, footPoses.at(supportFoot));
+
+  appendGaitPhase(footstep.transitStartTime, calcZmpWithOffset(footPoses), calcFootMidposZ(footPoses), footPoses);
+
+  appendGaitPhase(footstep.swingStartTime, supportFootZmp, calcFootMidposZ(footPoses),
+                  FootMap<sva::PTransformd>{{supportFoot, footPoses.at(supportFoot)}});
+
+  // Update footPoses
+  footPoses.at(footstep.foot) = footstep.pose;
+
+  appendGaitPhase(footstep.swingEndTime, supportFootZmp, calcFootMidposZ(footPoses), footPoses);
+
+  appendGaitPhase(footstep.transitEndTime, calcZmpWithOffset(footPoses), calcFootMidposZ(footPoses), footPoses);
+}
+
+void FootManager::appendGaitPhase(double startTime,
+                                  const Eigen::Vector3d & zmp,
+                                  double groundPosZ,
+                                  const FootMap<sva::PTransformd> & contactFootPoses)
+{
+  GaitPhase phase;
+  phase.startTime = startTime;
+  phase.zmp = zmp;
+  phase.groundPosZ = groundPosZ;
+  phase.contactFootPoses = contactFootPoses;
+
+  phase.supportRegionMin.setConstant(std::numeric_limits<double>::max());
+  phase.supportRegionMax.setConstant(std::numeric_limits<double>::lowest());
+  for(const auto & footPoseKV : contactFootPoses)
+  {
+    for(const auto & localVertex : localVertexList(footPoseKV.first))
+    {
+      Eigen::Vector2d pos = (sva::PTransformd(localVertex) * footPoseKV.second).translation().head<2>();
+      phase.supportRegionMin = phase.supportRegionMin.cwiseMin(pos);
+      phase.supportRegionMax = phase.supportRegionMax.cwiseMax(pos);
+    }
+  }
+
+  gaitTimeline_.appendPhase(phase);
+  zmpFunc_->appendPoint(std::make_pair(startTime, zmp));
+  groundPosZFunc_->appendPoint(std::make_pair(startTime, groundPosZ));
+}
+
 double FootManager::touchDownRemainingDuration() const
 {
   if(supportPhase_ == SupportPhase::DoubleSupport)
@@ -816,7 +1274,7 @@ double FootManager::touchDownRemainingDuration() const
   }
   else
   {
-    return swingFootstep_->swingEndTime - ctl().t();
+    return swingFootstep()->swingEndTime - ctl().t();
   }
 }
 
@@ -836,7 +1294,7 @@ bool FootManager::detectTouchDown() const
 
   // False if the position error does not meet the threshold
   Foot swingFoot = (supportPhase_ == SupportPhase::LeftSupport ? Foot::Right : Foot::Left);
-  if(((*swingPosFunc_)(swingFootstep_->swingEndTime) - (*swingPosFunc_)(ctl().t())).norm() > config_.touchDownPosError)
+  if(((*swingPosFunc_)(swingFootstep()->swingEndTime) - (*swingPosFunc_)(ctl().t())).norm() > config_.touchDownPosError)
   {
     return false;
   }
@@ -88,3 +88,24 @@ std::string std::to_string(const SupportPhase & phase)
     mc_rtc::log::error_and_throw("[to_string] Unsupported support phase: {}", std::to_string(static_cast<int>(phase)));
   }
 }
+
+std::string std::to_string(const ImpGainType & impGainType)
+{
+  if(impGainType == ImpGainType::SingleSupport)
+  {
+    return std::string("singleSupport");
+  }
+  else if(impGainType == ImpGainType::DoubleSupport)
+  {
+    return std::string("doubleSupport");
+  }
+  else if(impGainType == ImpGainType::Swing)
+  {
+    return std::string("swing");
+  }
+  else
+  {
+    mc_rtc::log::error_and_throw("[to_string] Unsupported impedance gain type: {}",
+                                 std::to_string(static_cast<int>(impGainType)));
+  }
+}
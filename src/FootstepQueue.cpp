@@ -0,0 +1,118 @@
+#include <mc_rtc/logging.h>
+
+#include <BaselineWalkingController/FootstepQueue.h>
+
+using namespace BWC;
+
+FootstepQueue::FootstepQueue(size_t capacity)
+{
+  reset(capacity);
+}
+
+void FootstepQueue::reset(size_t capacity)
+{
+  if(capacity == 0)
+  {
+    mc_rtc::log::error_and_throw("[FootstepQueue] Capacity must be positive.");
+  }
+
+  slots_.assign(capacity, Footstep(Foot::Left, sva::PTransformd::Identity()));
+  ids_.assign(capacity, 0);
+  head_ = 0;
+  size_.store(0, std::memory_order_relaxed);
+  revision_++;
+}
+
+bool FootstepQueue::push_back(const Footstep & footstep)
+{
+  if(full())
+  {
+    return false;
+  }
+
+  size_t slot = slotIdx(size());
+  slots_[slot] = footstep;
+  ids_[slot] = nextId_++;
+  size_.store(size() + 1, std::memory_order_relaxed);
+  revision_++;
+  return true;
+}
+
+bool FootstepQueue::append(const std::vector<Footstep> & footsteps)
+{
+  return replaceFrom(size(), footsteps);
+}
+
+bool FootstepQueue::replaceFrom(size_t idx, const std::vector<Footstep> & footsteps)
+{
+  if(idx > size() || footsteps.size() > capacity() - idx)
+  {
+    return false;
+  }
+
+  for(size_t i = idx; i < this->size(); i++)
+  {
+    ids_[slotIdx(i)] = 0;
+  }
+  size_t size = idx;
+  for(const auto & footstep : footsteps)
+  {
+    size_t slot = slotIdx(size);
+    slots_[slot] = footstep;
+    ids_[slot] = nextId_++;
+    size++;
+  }
+  size_.store(size, std::memory_order_relaxed);
+  revision_++;
+  return true;
+}
+
+void FootstepQueue::pop_front()
+{
+  if(empty())
+  {
+    return;
+  }
+
+  ids_[slotIdx(0)] = 0;
+  head_ = slotIdx(1);
+  size_.store(size() - 1, std::memory_order_relaxed);
+  revision_++;
+}
+
+void FootstepQueue::truncate(size_t size)
+{
+  if(size >= this->size())
+  {
+    return;
+  }
+
+  for(size_t idx = size; idx < this->size(); idx++)
+  {
+    ids_[slotIdx(idx)] = 0;
+  }
+  size_.store(size, std::memory_order_relaxed);
+  revision_++;
+}
+
+void FootstepQueue::clear()
+{
+  truncate(0);
+}
+
+void FootstepQueue::set(size_t idx, const Footstep & footstep)
+{
+  size_t slot = slotIdx(idx);
+  slots_[slot] = footstep;
+  ids_[slot] = nextId_++;
+  revision_++;
+}
+
+const Footstep * FootstepQueue::get(const Handle & handle) const
+{
+  if(handle.id == 0 || handle.slot >= capacity() || ids_[handle.slot] != handle.id)
+  {
+    return nullptr;
+  }
+  return &(slots_[handle.slot]);
+}
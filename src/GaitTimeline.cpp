@@ -0,0 +1,57 @@
+#include <algorithm>
+
+#include <BaselineWalkingController/GaitTimeline.h>
+
+using namespace BWC;
+
+namespace
+{
+bool compareStartTime(const GaitPhase & phase, double t)
+{
+  return phase.startTime < t;
+}
+
+bool compareStartTimeReverse(double t, const GaitPhase & phase)
+{
+  return t < phase.startTime;
+}
+} // namespace
+
+void GaitTimeline::clear()
+{
+  phases_.clear();
+}
+
+void GaitTimeline::appendPhase(const GaitPhase & phase)
+{
+  // Phases are usually added in chronological order, so check the end first
+  if(phases_.empty() || phases_.back().startTime < phase.startTime)
+  {
+    phases_.push_back(phase);
+    return;
+  }
+
+  auto it = std::lower_bound(phases_.begin(), phases_.end(), phase.startTime, compareStartTime);
+  if(it->startTime == phase.startTime)
+  {
+    return;
+  }
+  phases_.insert(it, phase);
+}
+
+void GaitTimeline::removePhasesBefore(double t)
+{
+  phases_.erase(phases_.begin(), std::lower_bound(phases_.begin(), phases_.end(), t, compareStartTime));
+}
+
+void GaitTimeline::removePhasesAfter(double t)
+{
+  phases_.erase(std::upper_bound(phases_.begin(), phases_.end(), t, compareStartTimeReverse), phases_.end());
+}
+
+int GaitTimeline::phaseIdx(double t) const
+{
+  return static_cast<int>(std::upper_bound(phases_.begin(), phases_.end(), t, compareStartTimeReverse)
+                          - phases_.begin())
+         - 1;
+}
@@ -1,3 +1,5 @@
+#include <algorithm>
+#include <chrono>
 #include <functional>
 
 #include <CCC/Constants.h>
@@ -15,6 +17,7 @@ void CentroidalManagerDdpZmp::Configuration::load(const mc_rtc::Configuration &
   mcRtcConfig("horizonDuration", horizonDuration);
   mcRtcConfig("horizonDt", horizonDt);
   mcRtcConfig("ddpMaxIter", ddpMaxIter);
+  mcRtcConfig("ddpMaxComputationDuration", ddpMaxComputationDuration);
 }
 
 CentroidalManagerDdpZmp::CentroidalManagerDdpZmp(BaselineWalkingController * ctlPtr,
@@ -24,24 +27,43 @@ CentroidalManagerDdpZmp::CentroidalManagerDdpZmp(BaselineWalkingController * ctl
   config_.load(mcRtcConfig);
 }
 
+CentroidalManagerDdpZmp::~CentroidalManagerDdpZmp()
+{
+  stopMpcThread();
+}
+
 void CentroidalManagerDdpZmp::reset()
 {
   CentroidalManager::reset();
 
   ddp_ = std::make_shared<CCC::DdpZmp>(robotMass_, config_.horizonDt,
                                        static_cast<int>(std::floor(config_.horizonDuration / config_.horizonDt)));
-  ddp_->ddp_solver_->config().max_iter = config_.ddpMaxIter;
+  // With the computation duration limit, DDP is iterated one at a time
+  ddp_->ddp_solver_->config().max_iter = (config_.ddpMaxComputationDuration > 0 ? 1 : config_.ddpMaxIter);
+
+  prevMpcTime_ = 0;
+  ddpIter_ = 0;
+  ddpComputationDuration_ = 0;
 }
 
 void CentroidalManagerDdpZmp::addToLogger(mc_rtc::Logger & logger)
 {
   CentroidalManager::addToLogger(logger);
 
-  logger.addLogEntry(config_.name + "_DDP_computationDuration", this,
-                     [this]() { return ddp_->ddp_solver_->computationDuration().solve; });
-  logger.addLogEntry(config_.name + "_DDP_iter", this, [this]() {
-    return ddp_->ddp_solver_->traceDataList().empty() ? 0 : ddp_->ddp_solver_->traceDataList().back().iter;
+  // In asynchronous mode, the solver is used in the MPC thread, so its status is not logged
+  logger.addLogEntry(config_.name + "_DDP_computationDuration", this, [this]() {
+    return config_.enableAsyncMpc ? 0.0 : ddpComputationDuration_;
   });
+  logger.addLogEntry(config_.name + "_DDP_iter", this, [this]() { return config_.enableAsyncMpc ? 0 : ddpIter_; });
+}
+
+void CentroidalManagerDdpZmp::prepareMpc()
+{
+  CentroidalManager::prepareMpc();
+  mpcDdpMaxIter_ = config_.ddpMaxIter;
+  mpcDdpMaxComputationDuration_ = config_.ddpMaxComputationDuration;
+
+  calcRefDataList(config_.horizonDuration, config_.horizonDt, true);
 }
 
 void CentroidalManagerDdpZmp::runMpc()
@@ -49,27 +71,103 @@ void CentroidalManagerDdpZmp::runMpc()
   CCC::DdpZmp::InitialParam initialParam;
   initialParam.pos = mpcCom_;
   initialParam.vel = mpcComVel_;
-  if(ddp_->ddp_solver_->controlData().u_list.size() == ddp_->ddp_solver_->config().horizon_steps)
+  calcInitialInputList(initialParam.u_list);
+
+  auto refDataFunc = std::bind(&CentroidalManagerDdpZmp::calcRefData, this, std::placeholders::_1);
+  CCC::DdpZmp::PlannedData plannedData;
+  if(mpcDdpMaxComputationDuration_ > 0)
   {
-    initialParam.u_list = ddp_->ddp_solver_->controlData().u_list;
+    // Iterate while the next iteration is expected to finish within the computation duration limit
+    auto startTime = std::chrono::steady_clock::now();
+    ddpIter_ = 0;
+    while(true)
+    {
+      plannedData = ddp_->planOnce(refDataFunc, initialParam, mpcTime_);
+      ddpIter_++;
+
+      ddpComputationDuration_ =
+          std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+      if(ddpIter_ >= mpcDdpMaxIter_
+         || ddpComputationDuration_ + ddp_->ddp_solver_->computationDuration().solve > mpcDdpMaxComputationDuration_)
+      {
+        break;
+      }
+      initialParam.u_list = ddp_->ddp_solver_->controlData().u_list;
+    }
   }
   else
   {
-    initialParam.u_list.assign(
-        ddp_->ddp_solver_->config().horizon_steps,
-        CCC::DdpZmp::DdpProblem::InputDimVector(mpcCom_.x(), mpcCom_.y(), robotMass_ * CCC::constants::g));
+    plannedData = ddp_->planOnce(refDataFunc, initialParam, mpcTime_);
+    ddpIter_ = ddp_->ddp_solver_->traceDataList().empty() ? 0 : ddp_->ddp_solver_->traceDataList().back().iter;
+    ddpComputationDuration_ = ddp_->ddp_solver_->computationDuration().solve;
   }
+  prevMpcTime_ = mpcTime_;
 
-  CCC::DdpZmp::PlannedData plannedData = ddp_->planOnce(
-      std::bind(&CentroidalManagerDdpZmp::calcRefData, this, std::placeholders::_1), initialParam, ctl().t());
-  plannedZmp_ << plannedData.zmp, refZmp_.z();
-  plannedForceZ_ = plannedData.force_z;
+  mpcZmp_ = plannedData.zmp;
+  mpcForceZ_ = plannedData.force_z;
+
+  // Publish the whole input sequence so that it is interpolated in the control thread
+  const auto & uList = ddp_->ddp_solver_->controlData().u_list;
+  mpcInputList_.resize(uList.size());
+  for(size_t i = 0; i < uList.size(); i++)
+  {
+    mpcInputList_[i] = uList[i];
+  }
+  mpcInputDt_ = refDataDt_;
 }
 
 CCC::DdpZmp::RefData CentroidalManagerDdpZmp::calcRefData(double t) const
 {
   CCC::DdpZmp::RefData refData;
-  refData.zmp = ctl().footManager_->calcRefZmp(t);
-  refData.com_z = config_.refComZ + ctl().footManager_->calcRefGroundPosZ(t);
+  int refDataIdx = this->refDataIdx(t);
+  if(refDataIdx < 0 && mpcAsync_)
+  {
+    // The foot manager must not be accessed in the MPC thread
+    refDataIdx = nearestRefDataIdx(t);
+  }
+  if(refDataIdx >= 0)
+  {
+    refData.zmp = refZmpList_.col(refDataIdx);
+    refData.com_z = mpcRefComZ_ + refGroundPosZList_(refDataIdx);
+  }
+  else
+  {
+    refData.zmp = ctl().footManager_->calcRefZmp(t);
+    refData.com_z = mpcRefComZ_ + ctl().footManager_->calcRefGroundPosZ(t);
+  }
   return refData;
 };
+
+void CentroidalManagerDdpZmp::calcInitialInputList(std::vector<CCC::DdpZmp::DdpProblem::InputDimVector> & uList) const
+{
+  const auto & prevUList = ddp_->ddp_solver_->controlData().u_list;
+  int horizonSteps = ddp_->ddp_solver_->config().horizon_steps;
+  double shiftedSteps = (mpcTime_ - prevMpcTime_) / refDataDt_;
+
+  // Without the previous solve, start from the constant input at the current CoM
+  if(static_cast<int>(prevUList.size()) != horizonSteps || shiftedSteps < 0)
+  {
+    uList.assign(horizonSteps,
+                 CCC::DdpZmp::DdpProblem::InputDimVector(mpcCom_.x(), mpcCom_.y(), robotMass_ * CCC::constants::g));
+    return;
+  }
+
+  uList.resize(horizonSteps);
+  for(int i = 0; i < horizonSteps; i++)
+  {
+    double prevIdx = i + shiftedSteps;
+    if(prevIdx <= horizonSteps - 1)
+    {
+      // Resample the previous input sequence by linear interpolation
+      int prevIdxFloor = static_cast<int>(std::floor(prevIdx));
+      int prevIdxCeil = std::min(prevIdxFloor + 1, horizonSteps - 1);
+      double ratio = prevIdx - prevIdxFloor;
+      uList[i] = (1 - ratio) * prevUList[prevIdxFloor] + ratio * prevUList[prevIdxCeil];
+    }
+    else
+    {
+      // Extrapolate the tail from the reference ZMP, which is sampled on the same time grid as the inputs
+      uList[i] << refZmpList_.col(i).head<2>(), robotMass_ * CCC::constants::g;
+    }
+  }
+}
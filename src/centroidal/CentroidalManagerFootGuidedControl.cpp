@@ -18,6 +18,11 @@ CentroidalManagerFootGuidedControl::CentroidalManagerFootGuidedControl(BaselineW
   config_.load(mcRtcConfig);
 }
 
+CentroidalManagerFootGuidedControl::~CentroidalManagerFootGuidedControl()
+{
+  stopMpcThread();
+}
+
 void CentroidalManagerFootGuidedControl::reset()
 {
   CentroidalManager::reset();
@@ -30,19 +35,23 @@ void CentroidalManagerFootGuidedControl::addToLogger(mc_rtc::Logger & logger)
   CentroidalManager::addToLogger(logger);
 
   logger.addLogEntry(config_.name + "_FootGuided_capturePoint", this, [this]() -> Eigen::Vector2d {
-    return mpcCom_.head<2>() + std::sqrt(config_.refComZ / CCC::constants::g) * mpcComVel_.head<2>();
+    return mpcPlan_.com.head<2>() + std::sqrt(config_.refComZ / CCC::constants::g) * mpcPlan_.comVel.head<2>();
   });
 }
 
+void CentroidalManagerFootGuidedControl::prepareMpc()
+{
+  CentroidalManager::prepareMpc();
+  refData_ = calcRefData();
+}
+
 void CentroidalManagerFootGuidedControl::runMpc()
 {
   CCC::FootGuidedControl::InitialParam initialParam =
-      mpcCom_.head<2>() + std::sqrt(config_.refComZ / CCC::constants::g) * mpcComVel_.head<2>();
-  CCC::FootGuidedControl::RefData refData = calcRefData();
+      mpcCom_.head<2>() + std::sqrt(mpcRefComZ_ / CCC::constants::g) * mpcComVel_.head<2>();
 
-  Eigen::Vector2d plannedData = footGuided_->planOnce(refData, initialParam, ctl().t());
-  plannedZmp_ << plannedData, refZmp_.z();
-  plannedForceZ_ = robotMass_ * CCC::constants::g;
+  mpcZmp_ = footGuided_->planOnce(refData_, initialParam, mpcTime_);
+  mpcForceZ_ = robotMass_ * CCC::constants::g;
 }
 
 CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData() const
@@ -61,13 +70,13 @@ CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData(
                                  {Foot::Right, ctl().footManager_->targetFootPose(Foot::Right)}})
             .head<2>();
     refData.transit_end_zmp = refData.transit_start_zmp;
-    refData.transit_start_time = ctl().t() + constantZmpDuration;
+    refData.transit_start_time = mpcTime_ + constantZmpDuration;
     refData.transit_duration = 0;
   }
   else
   {
     const auto & footstep = ctl().footManager_->footstepQueue().front();
-    if(ctl().t() < footstep.swingStartTime)
+    if(mpcTime_ < footstep.swingStartTime)
     {
       refData.transit_start_zmp =
           ctl()
@@ -131,9 +140,9 @@ CCC::FootGuidedControl::RefData CentroidalManagerFootGuidedControl::calcRefData(
     }
 
     // Ensure a horizon, since a horizon close to zero produces a very large input
-    if(refData.transit_start_time + refData.transit_duration < ctl().t() + horizonMargin)
+    if(refData.transit_start_time + refData.transit_duration < mpcTime_ + horizonMargin)
     {
-      refData.transit_duration = ctl().t() + horizonMargin - refData.transit_start_time;
+      refData.transit_duration = mpcTime_ + horizonMargin - refData.transit_start_time;
     }
   }
 
@@ -29,6 +29,11 @@ CentroidalManagerIntrinsicallyStableMpc::CentroidalManagerIntrinsicallyStableMpc
   config_.load(mcRtcConfig);
 }
 
+CentroidalManagerIntrinsicallyStableMpc::~CentroidalManagerIntrinsicallyStableMpc()
+{
+  stopMpcThread();
+}
+
 void CentroidalManagerIntrinsicallyStableMpc::reset()
 {
   CentroidalManager::reset();
@@ -37,37 +42,52 @@ void CentroidalManagerIntrinsicallyStableMpc::reset()
                                                        config_.qpSolverType);
 
   firstIter_ = true;
+
+  refZmpLimitsList_.clear();
+  zmpLimits_ = {Eigen::Vector2d::Zero(), Eigen::Vector2d::Zero()};
 }
 
 void CentroidalManagerIntrinsicallyStableMpc::addToLogger(mc_rtc::Logger & logger)
 {
   CentroidalManager::addToLogger(logger);
 
-  logger.addLogEntry(config_.name + "_IntrinsicallyStableMpc_zmpLimits_min", this,
-                     [this]() { return calcRefData(ctl().t()).zmp_limits[0]; });
-  logger.addLogEntry(config_.name + "_IntrinsicallyStableMpc_zmpLimits_max", this,
-                     [this]() { return calcRefData(ctl().t()).zmp_limits[1]; });
+  logger.addLogEntry(config_.name + "_IntrinsicallyStableMpc_zmpLimits_min", this, [this]() { return zmpLimits_[0]; });
+  logger.addLogEntry(config_.name + "_IntrinsicallyStableMpc_zmpLimits_max", this, [this]() { return zmpLimits_[1]; });
+}
+
+void CentroidalManagerIntrinsicallyStableMpc::setMpcWarmStart(const Eigen::Vector2d & zmp, double forceZ)
+{
+  CentroidalManager::setMpcWarmStart(zmp, forceZ);
+
+  // Use the planned ZMP in the first iteration after switching
+  firstIter_ = false;
+}
+
+void CentroidalManagerIntrinsicallyStableMpc::prepareMpc()
+{
+  CentroidalManager::prepareMpc();
+  calcRefDataList(config_.horizonDuration, config_.horizonDt, false);
+  calcRefZmpLimitsList();
 }
 
 void CentroidalManagerIntrinsicallyStableMpc::runMpc()
 {
   CCC::IntrinsicallyStableMpc::InitialParam initialParam;
   initialParam.capture_point =
-      mpcCom_.head<2>() + std::sqrt(config_.refComZ / CCC::constants::g) * mpcComVel_.head<2>();
+      mpcCom_.head<2>() + std::sqrt(mpcRefComZ_ / CCC::constants::g) * mpcComVel_.head<2>();
   if(firstIter_)
   {
     initialParam.planned_zmp = mpcCom_.head<2>();
   }
   else
   {
-    initialParam.planned_zmp = plannedZmp_.head<2>();
+    initialParam.planned_zmp = mpcZmp_;
   }
 
-  Eigen::Vector2d plannedData =
+  mpcZmp_ =
       mpc_->planOnce(std::bind(&CentroidalManagerIntrinsicallyStableMpc::calcRefData, this, std::placeholders::_1),
-                     initialParam, ctl().t(), ctl().dt());
-  plannedZmp_ << plannedData, refZmp_.z();
-  plannedForceZ_ = robotMass_ * CCC::constants::g;
+                     initialParam, mpcTime_, ctl().dt());
+  mpcForceZ_ = robotMass_ * CCC::constants::g;
 
   if(firstIter_)
   {
@@ -78,21 +98,58 @@ void CentroidalManagerIntrinsicallyStableMpc::runMpc()
 CCC::IntrinsicallyStableMpc::RefData CentroidalManagerIntrinsicallyStableMpc::calcRefData(double t) const
 {
   CCC::IntrinsicallyStableMpc::RefData refData;
-  refData.zmp = ctl().footManager_->calcRefZmp(t).head<2>();
-  Eigen::Vector2d minPos = Eigen::Vector2d::Constant(std::numeric_limits<double>::max());
-  Eigen::Vector2d maxPos = Eigen::Vector2d::Constant(std::numeric_limits<double>::lowest());
-  for(const auto & footPoseKV : ctl().footManager_->calcContactFootPoses(t))
+  int refDataIdx = this->refDataIdx(t);
+  if(refDataIdx < 0 && mpcAsync_)
   {
-    const auto & surface = ctl().robot().surface(ctl().footManager_->surfaceName(footPoseKV.first));
-    for(const auto & point : surface.points())
-    {
-      // Surface points are represented in body frame, not surface frame
-      Eigen::Vector2d pos = (point * surface.X_b_s().inv() * footPoseKV.second).translation().head<2>();
-      minPos = minPos.cwiseMin(pos);
-      maxPos = maxPos.cwiseMax(pos);
-    }
+    // The foot manager must not be accessed in the MPC thread
+    refDataIdx = nearestRefDataIdx(t);
+  }
+  if(refDataIdx >= 0)
+  {
+    refData.zmp = refZmpList_.col(refDataIdx).head<2>();
+    refData.zmp_limits[0] = refZmpLimitsList_[refDataIdx][0];
+    refData.zmp_limits[1] = refZmpLimitsList_[refDataIdx][1];
+  }
+  else
+  {
+    refData.zmp = ctl().footManager_->calcRefZmp(t).head<2>();
+    const auto & zmpLimits = calcZmpLimits(ctl().footManager_->gaitTimeline().phaseIdx(t));
+    refData.zmp_limits[0] = zmpLimits[0];
+    refData.zmp_limits[1] = zmpLimits[1];
   }
-  refData.zmp_limits[0] = minPos;
-  refData.zmp_limits[1] = maxPos;
   return refData;
 };
+
+void CentroidalManagerIntrinsicallyStableMpc::calcRefZmpLimitsList()
+{
+  const auto & gaitTimeline = ctl().footManager_->gaitTimeline();
+
+  // Since the sample times are increasing, the phase index is advanced instead of searched for each sample
+  refZmpLimitsList_.resize(refZmpList_.cols());
+  int phaseIdx = gaitTimeline.phaseIdx(refDataStartTime_);
+  for(int i = 0; i < static_cast<int>(refZmpLimitsList_.size()); i++)
+  {
+    double t = refDataStartTime_ + i * refDataDt_;
+    while(phaseIdx + 1 < static_cast<int>(gaitTimeline.size()) && gaitTimeline.phase(phaseIdx + 1).startTime <= t)
+    {
+      phaseIdx++;
+    }
+    refZmpLimitsList_[i] = calcZmpLimits(phaseIdx);
+  }
+
+  zmpLimits_ = refZmpLimitsList_.empty() ? calcZmpLimits(gaitTimeline.phaseIdx(mpcTime_)) : refZmpLimitsList_[0];
+}
+
+std::array<Eigen::Vector2d, 2> CentroidalManagerIntrinsicallyStableMpc::calcZmpLimits(int phaseIdx) const
+{
+  if(phaseIdx >= 0)
+  {
+    const auto & phase = ctl().footManager_->gaitTimeline().phase(phaseIdx);
+    return {phase.supportRegionMin, phase.supportRegionMax};
+  }
+  else
+  {
+    return {Eigen::Vector2d::Constant(std::numeric_limits<double>::max()),
+            Eigen::Vector2d::Constant(std::numeric_limits<double>::lowest())};
+  }
+}
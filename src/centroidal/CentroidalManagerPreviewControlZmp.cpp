@@ -23,6 +23,11 @@ CentroidalManagerPreviewControlZmp::CentroidalManagerPreviewControlZmp(BaselineW
   config_.load(mcRtcConfig);
 }
 
+CentroidalManagerPreviewControlZmp::~CentroidalManagerPreviewControlZmp()
+{
+  stopMpcThread();
+}
+
 void CentroidalManagerPreviewControlZmp::reset()
 {
   CentroidalManager::reset();
@@ -32,6 +37,20 @@ void CentroidalManagerPreviewControlZmp::reset()
   firstIter_ = true;
 }
 
+void CentroidalManagerPreviewControlZmp::setMpcWarmStart(const Eigen::Vector2d & zmp, double forceZ)
+{
+  CentroidalManager::setMpcWarmStart(zmp, forceZ);
+
+  // Use the planned ZMP in the first iteration after switching
+  firstIter_ = false;
+}
+
+void CentroidalManagerPreviewControlZmp::prepareMpc()
+{
+  CentroidalManager::prepareMpc();
+  calcRefDataList(config_.horizonDuration, config_.horizonDt, false);
+}
+
 void CentroidalManagerPreviewControlZmp::runMpc()
 {
   CCC::PreviewControlZmp::InitialParam initialParam;
@@ -44,14 +63,13 @@ void CentroidalManagerPreviewControlZmp::runMpc()
   else
   {
     // Since the actual CoM acceleration cannot be obtained, the CoM acceleration is always calculated from LIPM dynamics
-    initialParam.acc = CCC::constants::g / config_.refComZ * (mpcCom_ - plannedZmp_).head<2>();
+    initialParam.acc = CCC::constants::g / mpcRefComZ_ * (mpcCom_.head<2>() - mpcZmp_);
   }
 
-  Eigen::Vector2d plannedData =
+  mpcZmp_ =
       pc_->planOnce(std::bind(&CentroidalManagerPreviewControlZmp::calcRefData, this, std::placeholders::_1),
-                    initialParam, ctl().t(), ctl().dt());
-  plannedZmp_ << plannedData, refZmp_.z();
-  plannedForceZ_ = robotMass_ * CCC::constants::g;
+                    initialParam, mpcTime_, ctl().dt());
+  mpcForceZ_ = robotMass_ * CCC::constants::g;
 
   if(firstIter_)
   {
@@ -61,5 +79,15 @@ void CentroidalManagerPreviewControlZmp::runMpc()
 
 Eigen::Vector2d CentroidalManagerPreviewControlZmp::calcRefData(double t) const
 {
+  int refDataIdx = this->refDataIdx(t);
+  if(refDataIdx < 0 && mpcAsync_)
+  {
+    // The foot manager must not be accessed in the MPC thread
+    refDataIdx = nearestRefDataIdx(t);
+  }
+  if(refDataIdx >= 0)
+  {
+    return refZmpList_.col(refDataIdx).head<2>();
+  }
   return ctl().footManager_->calcRefZmp(t).head<2>();
 };
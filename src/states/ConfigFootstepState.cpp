@@ -13,6 +13,7 @@ void ConfigFootstepState::start(mc_control::fsm::Controller & _ctl)
   {
     Foot foot = Foot::Left;
     double startTime = ctl().t();
+    std::vector<Footstep> footstepList;
 
     for(const auto & footstepConfig : config_("configs")("footstepList"))
     {
@@ -24,13 +25,14 @@ void ConfigFootstepState::start(mc_control::fsm::Controller & _ctl)
       {
         startTime = ctl().t() + static_cast<double>(footstepConfig("startTime"));
       }
-      const auto & footstep = ctl().footManager_->makeFootstep(foot, footstepConfig("footMidpose"), startTime,
-                                                               (footstepConfig("config", mc_rtc::Configuration())));
-      ctl().footManager_->appendFootstep(footstep);
+      footstepList.push_back(ctl().footManager_->makeFootstep(foot, footstepConfig("footMidpose"), startTime,
+                                                              (footstepConfig("config", mc_rtc::Configuration()))));
 
       foot = opposite(foot);
-      startTime = footstep.transitEndTime;
+      startTime = footstepList.back().transitEndTime;
     }
+
+    ctl().footManager_->appendFootsteps(footstepList);
   }
 
   output("OK");
@@ -134,6 +134,20 @@ void FootstepPlannerState::start(mc_control::fsm::Controller & _ctl)
 
 bool FootstepPlannerState::run(mc_control::fsm::Controller &)
 {
+  // Submit the planned footsteps in the control thread, since the footstep queue is modified only in this thread
+  std::vector<Footstep> footstepList;
+  {
+    std::unique_lock<std::mutex> lock(plannedFootstepMutex_, std::try_to_lock);
+    if(lock.owns_lock())
+    {
+      footstepList.swap(plannedFootstepList_);
+    }
+  }
+  if(!footstepList.empty())
+  {
+    ctl().footManager_->appendFootsteps(footstepList);
+  }
+
   return false;
 }
 
@@ -174,7 +188,7 @@ void FootstepPlannerState::planningThread()
           return sva::PTransformd(sva::RotZ(trans.z()), Eigen::Vector3d(trans.x(), trans.y(), 0));
         };
 
-        std::unordered_map<Foot, Eigen::Vector3d> footPoses2d = {
+        FootMap<Eigen::Vector3d> footPoses2d = {
             {Foot::Left, convertTo2d(ctl().footManager_->targetFootPose(Foot::Left))},
             {Foot::Right, convertTo2d(ctl().footManager_->targetFootPose(Foot::Right))}};
         footstepPlanner_->setStartGoal(
@@ -193,6 +207,7 @@ void FootstepPlannerState::planningThread()
         if(footstepPlanner_->solution_.is_solved)
         {
           double startTime = ctl().t() + 1.0;
+          std::vector<Footstep> footstepList;
           for(auto it = footstepPlanner_->solution_.state_list.begin() + 2;
               it != footstepPlanner_->solution_.state_list.end(); it++)
           {
@@ -208,9 +223,11 @@ void FootstepPlannerState::planningThread()
                                   + (1.0 - 0.5 * ctl().footManager_->config().doubleSupportRatio)
                                         * ctl().footManager_->config().footstepDuration,
                               startTime + ctl().footManager_->config().footstepDuration);
-            ctl().footManager_->appendFootstep(footstep);
+            footstepList.push_back(footstep);
             startTime = footstep.transitEndTime;
           }
+          std::lock_guard<std::mutex> lock(plannedFootstepMutex_);
+          plannedFootstepList_ = std::move(footstepList);
         }
         else
         {
@@ -88,6 +88,7 @@ void GuiFootstepState::sendFootstepList(const Eigen::Vector3d & goalTrans, // (x
   Foot foot = goalTrans.y() >= 0 ? Foot::Left : Foot::Right;
   sva::PTransformd footMidpose = initialFootMidpose;
   double startTime = ctl().t() + 1.0;
+  std::vector<Footstep> footstepList;
 
   while(convertTo2d(goalFootMidpose * footMidpose.inv()).norm() > 1e-6)
   {
@@ -105,21 +106,21 @@ void GuiFootstepState::sendFootstepList(const Eigen::Vector3d & goalTrans, // (x
     mc_filter::utils::clampInPlace(deltaTrans, deltaTransMin, deltaTransMax);
     footMidpose = convertTo3d(deltaTrans) * footMidpose;
 
-    const auto & footstep = ctl().footManager_->makeFootstep(foot, footMidpose, startTime);
-    ctl().footManager_->appendFootstep(footstep);
+    footstepList.push_back(ctl().footManager_->makeFootstep(foot, footMidpose, startTime));
 
     foot = opposite(foot);
-    startTime = footstep.transitEndTime;
+    startTime = footstepList.back().transitEndTime;
   }
 
   for(int i = 0; i < lastFootstepNum + 1; i++)
   {
-    const auto & footstep = ctl().footManager_->makeFootstep(foot, footMidpose, startTime);
-    ctl().footManager_->appendFootstep(footstep);
+    footstepList.push_back(ctl().footManager_->makeFootstep(foot, footMidpose, startTime));
 
     foot = opposite(foot);
-    startTime = footstep.transitEndTime;
+    startTime = footstepList.back().transitEndTime;
   }
+
+  ctl().footManager_->appendFootsteps(footstepList);
 }
 
 EXPORT_SINGLE_STATE("BWC::GuiFootstep", GuiFootstepState)
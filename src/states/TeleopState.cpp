@@ -119,17 +119,16 @@ bool TeleopState::run(mc_control::fsm::Controller &)
       return sva::PTransformd(sva::RotZ(trans.z()), Eigen::Vector3d(trans.x(), trans.y(), 0));
     };
 
-    auto & footstepQueue = ctl().footManager_->footstepQueue();
     // Do not change the next footstep
-    // Delete the second and subsequent footsteps, and add new ones
-    footstepQueue.erase(footstepQueue.begin() + 1, footstepQueue.end());
-    const auto & nextFootstep = footstepQueue.front();
+    // Replace the second and subsequent footsteps with new ones
+    const auto & nextFootstep = ctl().footManager_->footstepQueue().front();
 
     // Append new footstep
     Foot foot = opposite(nextFootstep.foot);
     sva::PTransformd footMidpose = projGround(
         sva::interpolate(ctl().footManager_->targetFootPose(opposite(nextFootstep.foot)), nextFootstep.pose, 0.5));
     double startTime = nextFootstep.transitEndTime;
+    std::vector<Footstep> footstepList;
     for(int i = 0; i < footstepQueueSize_ - 1; i++)
     {
       Eigen::Vector3d deltaTransMax = deltaTransLimit_;
@@ -145,12 +144,13 @@ bool TeleopState::run(mc_control::fsm::Controller &)
       Eigen::Vector3d deltaTrans = mc_filter::utils::clamp(targetDeltaTrans_, deltaTransMin, deltaTransMax);
       footMidpose = convertTo3d(deltaTrans) * footMidpose;
 
-      const auto & footstep = ctl().footManager_->makeFootstep(foot, footMidpose, startTime);
-      footstepQueue.push_back(footstep);
+      footstepList.push_back(ctl().footManager_->makeFootstep(foot, footMidpose, startTime));
 
       foot = opposite(foot);
-      startTime = footstep.transitEndTime;
+      startTime = footstepList.back().transitEndTime;
     }
+
+    ctl().footManager_->replaceFootstepsFrom(1, footstepList);
   }
 
   return false;
@@ -173,14 +173,16 @@ void TeleopState::startTeleop()
   const sva::PTransformd & footMidpose = projGround(sva::interpolate(
       ctl().footManager_->targetFootPose(Foot::Left), ctl().footManager_->targetFootPose(Foot::Right), 0.5));
   double startTime = ctl().t() + 1.0;
+  std::vector<Footstep> footstepList;
   for(int i = 0; i < footstepQueueSize_; i++)
   {
-    const auto & footstep = ctl().footManager_->makeFootstep(foot, footMidpose, startTime);
-    ctl().footManager_->appendFootstep(footstep);
+    footstepList.push_back(ctl().footManager_->makeFootstep(foot, footMidpose, startTime));
 
     foot = opposite(foot);
-    startTime = footstep.transitEndTime;
+    startTime = footstepList.back().transitEndTime;
   }
+
+  ctl().footManager_->appendFootsteps(footstepList);
 }
 
 void TeleopState::endTeleop()
@@ -191,10 +193,12 @@ void TeleopState::endTeleop()
 
   // Update last footstep pose to align both feet
   const auto & footManagerConfig = ctl().footManager_->config();
-  const auto & lastFootstep1 = *(ctl().footManager_->footstepQueue().rbegin() + 1);
-  auto & lastFootstep2 = *(ctl().footManager_->footstepQueue().rbegin());
+  auto & footstepQueue = ctl().footManager_->mutableFootstepQueue();
+  const auto & lastFootstep1 = footstepQueue[footstepQueue.size() - 2];
+  Footstep lastFootstep2 = footstepQueue.back();
   sva::PTransformd footMidpose = footManagerConfig.midToFootTranss.at(lastFootstep1.foot).inv() * lastFootstep1.pose;
   lastFootstep2.pose = footManagerConfig.midToFootTranss.at(lastFootstep2.foot) * footMidpose;
+  footstepQueue.set(footstepQueue.size() - 1, lastFootstep2);
 }
 
 void TeleopState::twistCallback(const geometry_msgs::Twist::ConstPtr & twistMsg)
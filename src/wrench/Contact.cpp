@@ -17,39 +17,59 @@ FrictionPyramid::FrictionPyramid(double fricCoeff, int ridgeNum)
 
 std::vector<Eigen::Vector3d> FrictionPyramid::calcGlobalRidgeList(const Eigen::Matrix3d & rot) const
 {
-  std::vector<Eigen::Vector3d> globalRidgeList;
-  for(const auto & localRidge : localRidgeList_)
+  std::vector<Eigen::Vector3d> globalRidgeList(localRidgeList_.size());
+  calcGlobalRidgeList(rot, globalRidgeList);
+  return globalRidgeList;
+}
+
+void FrictionPyramid::calcGlobalRidgeList(const Eigen::Matrix3d & rot,
+                                          std::vector<Eigen::Vector3d> & globalRidgeList) const
+{
+  assert(globalRidgeList.size() == localRidgeList_.size());
+
+  for(size_t ridgeIdx = 0; ridgeIdx < localRidgeList_.size(); ridgeIdx++)
   {
-    globalRidgeList.push_back(rot * localRidge);
+    globalRidgeList[ridgeIdx].noalias() = rot * localRidgeList_[ridgeIdx];
   }
-  return globalRidgeList;
 }
 
 Contact::Contact(const std::string & name,
                  double fricCoeff,
                  const std::vector<Eigen::Vector3d> & localVertexList,
-                 const sva::PTransformd & pose)
-: name_(name)
+                 const sva::PTransformd & pose,
+                 int ridgeNum)
+: name_(name), fricCoeff_(fricCoeff), fricPyramid_(fricCoeff, ridgeNum), localVertexList_(localVertexList)
 {
-  // Set graspMat_ and vertexWithRidgeList_
-  FrictionPyramid fricPyramid(fricCoeff);
+  // Allocate graspMat_ and vertexWithRidgeList_, which are overwritten in updatePose
+  graspMat_.resize(6, localVertexList_.size() * fricPyramid_.ridgeNum());
+  vertexWithRidgeList_.reserve(localVertexList_.size());
+  for(const auto & localVertex : localVertexList_)
+  {
+    vertexWithRidgeList_.push_back(VertexWithRidge(localVertex, fricPyramid_.localRidgeList_));
+  }
+
+  updatePose(pose);
+}
 
-  graspMat_.resize(6, localVertexList.size() * fricPyramid.ridgeNum());
+void Contact::updatePose(const sva::PTransformd & pose)
+{
+  pose_ = pose;
 
-  const auto & globalRidgeList = fricPyramid.calcGlobalRidgeList(pose.rotation().transpose());
+  const Eigen::Matrix3d rot = pose.rotation().transpose();
+  int ridgeNum = fricPyramid_.ridgeNum();
 
-  for(int vertexIdx = 0; vertexIdx < localVertexList.size(); vertexIdx++)
+  for(int vertexIdx = 0; vertexIdx < static_cast<int>(localVertexList_.size()); vertexIdx++)
   {
-    Eigen::Vector3d globalVertex = (sva::PTransformd(localVertexList[vertexIdx]) * pose).translation();
+    auto & vertexWithRidge = vertexWithRidgeList_[vertexIdx];
+    vertexWithRidge.vertex = (sva::PTransformd(localVertexList_[vertexIdx]) * pose).translation();
+    fricPyramid_.calcGlobalRidgeList(rot, vertexWithRidge.ridgeList);
 
-    for(int ridgeIdx = 0; ridgeIdx < globalRidgeList.size(); ridgeIdx++)
+    for(int ridgeIdx = 0; ridgeIdx < ridgeNum; ridgeIdx++)
     {
-      const auto & globalRidge = globalRidgeList[ridgeIdx];
+      const auto & globalRidge = vertexWithRidge.ridgeList[ridgeIdx];
       // The top 3 rows are moment, the bottom 3 rows are force.
-      graspMat_.col(vertexIdx * fricPyramid.ridgeNum() + ridgeIdx) << globalVertex.cross(globalRidge), globalRidge;
+      graspMat_.col(vertexIdx * ridgeNum + ridgeIdx) << vertexWithRidge.vertex.cross(globalRidge), globalRidge;
     }
-
-    vertexWithRidgeList_.push_back(VertexWithRidge(globalVertex, globalRidgeList));
   }
 }
 
@@ -1,3 +1,7 @@
+#include <chrono>
+
+#include <mc_rtc/logging.h>
+
 #include <BaselineWalkingController/wrench/Contact.h>
 #include <BaselineWalkingController/wrench/WrenchDistribution.h>
 
@@ -8,32 +12,95 @@ void WrenchDistribution::Configuration::load(const mc_rtc::Configuration & mcRtc
   mcRtcConfig("wrenchWeight", wrenchWeight);
   mcRtcConfig("regularWeight", regularWeight);
   mcRtcConfig("ridgeForceMinMax", ridgeForceMinMax);
+  mcRtcConfig("enableWarmStart", enableWarmStart);
+  mcRtcConfig("solverMode", solverMode);
+  if(solverMode == "Qp")
+  {
+    solverModeType = SolverMode::Qp;
+  }
+  else if(solverMode == "ActiveSet")
+  {
+    solverModeType = SolverMode::ActiveSet;
+  }
+  else
+  {
+    mc_rtc::log::error_and_throw("[WrenchDistribution] Invalid solverMode: {}.", solverMode);
+  }
+  mcRtcConfig("qpSolverType", qpSolverType);
 }
 
-WrenchDistribution::WrenchDistribution(const std::unordered_map<Foot, std::shared_ptr<Contact>> & contactList,
+WrenchDistribution::WrenchDistribution(const FootMap<std::shared_ptr<Contact>> & contactList,
                                        const mc_rtc::Configuration & mcRtcConfig)
 : contactList_(contactList)
 {
   config_.load(mcRtcConfig);
 
+  setContactList(contactList);
+
+  qpSolver_ = QpSolverCollection::allocateQpSolver(QpSolverCollection::strToQpSolverType(config_.qpSolverType));
+}
+
+void WrenchDistribution::setContactList(const FootMap<std::shared_ptr<Contact>> & contactList)
+{
+  if(contactList.size() != contactList_.size())
+  {
+    mc_rtc::log::error_and_throw("[WrenchDistribution] Number of contacts is inconsistent: {} != {}",
+                                 contactList.size(), contactList_.size());
+  }
+
+  // Only the contact pointers are replaced
   int colNum = 0;
-  for(const auto & contactKV : contactList_)
+  for(const auto & contactKV : contactList)
   {
+    contactList_.at(contactKV.first) = contactKV.second;
     colNum += contactKV.second->graspMat_.cols();
   }
-  resultWrenchRatio_ = Eigen::VectorXd::Zero(colNum);
 
-  QpSolverCollection::QpSolverType qpSolverType = QpSolverCollection::QpSolverType::Any;
-  if(mcRtcConfig.has("qpSolverType"))
+  if(resultWrenchRatio_.size() != colNum)
   {
-    qpSolverType = QpSolverCollection::strToQpSolverType(mcRtcConfig("qpSolverType"));
+    resultWrenchRatio_ = Eigen::VectorXd::Zero(colNum);
+    totalGraspMat_.resize(6, colNum);
+    weightedGraspMat_.resize(6, colNum);
+
+    warmStartAvailable_ = false;
+    warmStartWrenchRatio_.resize(colNum);
+    freeIdxList_.resize(colNum);
+    reducedObjMat_.resize(colNum, colNum);
+    reducedObjVec_.resize(colNum);
+    objGrad_.resize(colNum);
+    boundStateList_.resize(colNum);
+    candidateWrenchRatio_.resize(colNum);
   }
-  qpSolver_ = QpSolverCollection::allocateQpSolver(qpSolverType);
+}
+
+template<int VarDim>
+void WrenchDistribution::setQpObjective()
+{
+  Eigen::Map<const Eigen::Matrix<double, 6, VarDim>> graspMat(totalGraspMat_.data(), 6, totalGraspMat_.cols());
+
+  if constexpr(VarDim == Eigen::Dynamic)
+  {
+    weightedGraspMat_.noalias() = config_.wrenchWeight.vector().asDiagonal() * graspMat;
+    qpCoeff_.obj_mat_.noalias() = graspMat.transpose() * weightedGraspMat_;
+    qpCoeff_.obj_vec_.noalias() = -1 * weightedGraspMat_.transpose() * desiredTotalWrench_.vector();
+  }
+  else
+  {
+    const Eigen::Matrix<double, 6, VarDim> weightedGraspMat = config_.wrenchWeight.vector().asDiagonal() * graspMat;
+    const Eigen::Matrix<double, VarDim, VarDim> objMat = graspMat.transpose() * weightedGraspMat;
+    qpCoeff_.obj_mat_ = objMat;
+    qpCoeff_.obj_vec_.noalias() = -1 * weightedGraspMat.transpose() * desiredTotalWrench_.vector();
+  }
+  qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
 }
 
 sva::ForceVecd WrenchDistribution::run(const sva::ForceVecd & desiredTotalWrench, const Eigen::Vector3d & momentOrigin)
 {
+  auto startTime = std::chrono::steady_clock::now();
+
   desiredTotalWrench_ = desiredTotalWrench;
+  solveStat_.warmStarted = false;
+  solveStat_.iterNum = 0;
 
   // Return if variable dimension is zero
   if(resultWrenchRatio_.size() == 0)
@@ -42,49 +109,323 @@ sva::ForceVecd WrenchDistribution::run(const sva::ForceVecd & desiredTotalWrench
     return resultTotalWrench_;
   }
 
-  // Construct totalGraspMat
-  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat(6, resultWrenchRatio_.size());
+  // Set totalGraspMat_
   {
     int colNum = 0;
     for(const auto & contactKV : contactList_)
     {
-      totalGraspMat.middleCols(colNum, contactKV.second->graspMat_.cols()) = contactKV.second->graspMat_;
+      totalGraspMat_.middleCols(colNum, contactKV.second->graspMat_.cols()) = contactKV.second->graspMat_;
       colNum += contactKV.second->graspMat_.cols();
     }
     if(momentOrigin.norm() > 0)
     {
       for(int i = 0; i < colNum; i++)
       {
-        // totalGraspMat.col(i).tail<3>() is the force ridge
-        totalGraspMat.col(i).head<3>() -= momentOrigin.cross(totalGraspMat.col(i).tail<3>());
+        // totalGraspMat_.col(i).tail<3>() is the force ridge
+        totalGraspMat_.col(i).head<3>() -= momentOrigin.cross(totalGraspMat_.col(i).tail<3>());
       }
     }
   }
 
+  // Solve with the active set method
+  bool solved = false;
+  if(config_.solverModeType == SolverMode::ActiveSet)
+  {
+    bool warmStart = config_.enableWarmStart && warmStartAvailable_;
+    solved = solveActiveSet(warmStart);
+    solveStat_.warmStarted = solved && warmStart;
+  }
+
   // Solve QP
+  if(!solved)
   {
     int varDim = resultWrenchRatio_.size();
     if(qpCoeff_.dim_var_ != varDim)
     {
       qpCoeff_.setup(varDim, 0, 0);
     }
-    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
-    qpCoeff_.obj_mat_.noalias() = totalGraspMat.transpose() * weightMat * totalGraspMat;
-    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
-    qpCoeff_.obj_vec_.noalias() = -1 * totalGraspMat.transpose() * weightMat * desiredTotalWrench_.vector();
+    if(varDim == footVarDim)
+    {
+      setQpObjective<footVarDim>();
+    }
+    else if(varDim == 2 * footVarDim)
+    {
+      setQpObjective<2 * footVarDim>();
+    }
+    else
+    {
+      setQpObjective<Eigen::Dynamic>();
+    }
     qpCoeff_.x_min_.setConstant(varDim, config_.ridgeForceMinMax.first);
     qpCoeff_.x_max_.setConstant(varDim, config_.ridgeForceMinMax.second);
-    resultWrenchRatio_ = qpSolver_->solve(qpCoeff_);
+    if(config_.solverModeType == SolverMode::Qp && config_.enableWarmStart && warmStartAvailable_
+       && solveWithWarmStart())
+    {
+      solveStat_.warmStarted = true;
+    }
+    else
+    {
+      resultWrenchRatio_ = qpSolver_->solve(qpCoeff_);
+    }
   }
+  warmStartAvailable_ = true;
 
-  resultTotalWrench_ = sva::ForceVecd(totalGraspMat * resultWrenchRatio_);
+  resultTotalWrench_ = sva::ForceVecd(totalGraspMat_ * resultWrenchRatio_);
+
+  solveStat_.duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
 
   return resultTotalWrench_;
 }
 
-std::unordered_map<Foot, sva::ForceVecd> WrenchDistribution::calcWrenchList(const Eigen::Vector3d & momentOrigin) const
+bool WrenchDistribution::solveWithWarmStart()
+{
+  constexpr double thre = 1e-6;
+  int varDim = static_cast<int>(resultWrenchRatio_.size());
+  double lowerForce = config_.ridgeForceMinMax.first;
+  double upperForce = config_.ridgeForceMinMax.second;
+
+  // Fix the variables at the bounds in the previous result and set the other variables to zero
+  int freeNum = 0;
+  for(int i = 0; i < varDim; i++)
+  {
+    if(resultWrenchRatio_(i) <= lowerForce + thre)
+    {
+      warmStartWrenchRatio_(i) = lowerForce;
+    }
+    else if(resultWrenchRatio_(i) >= upperForce - thre)
+    {
+      warmStartWrenchRatio_(i) = upperForce;
+    }
+    else
+    {
+      warmStartWrenchRatio_(i) = 0;
+      freeIdxList_(freeNum) = i;
+      freeNum++;
+    }
+  }
+
+  // Solve the equality-constrained problem of the free variables
+  if(freeNum > 0)
+  {
+    objGrad_.noalias() = qpCoeff_.obj_mat_ * warmStartWrenchRatio_;
+    objGrad_ += qpCoeff_.obj_vec_;
+
+    auto reducedObjMat = reducedObjMat_.topLeftCorner(freeNum, freeNum);
+    auto reducedObjVec = reducedObjVec_.head(freeNum);
+    for(int i = 0; i < freeNum; i++)
+    {
+      for(int j = 0; j < freeNum; j++)
+      {
+        reducedObjMat(i, j) = qpCoeff_.obj_mat_(freeIdxList_(i), freeIdxList_(j));
+      }
+      reducedObjVec(i) = -1 * objGrad_(freeIdxList_(i));
+    }
+
+    // Decompose in place to avoid allocation
+    Eigen::LLT<Eigen::Ref<Eigen::MatrixXd>> llt(reducedObjMat);
+    if(llt.info() != Eigen::Success)
+    {
+      return false;
+    }
+    llt.solveInPlace(reducedObjVec);
+
+    // Check primal feasibility
+    for(int i = 0; i < freeNum; i++)
+    {
+      if(reducedObjVec(i) < lowerForce - thre || upperForce + thre < reducedObjVec(i))
+      {
+        return false;
+      }
+      warmStartWrenchRatio_(freeIdxList_(i)) = std::min(std::max(reducedObjVec(i), lowerForce), upperForce);
+    }
+  }
+
+  // Check dual feasibility
+  objGrad_.noalias() = qpCoeff_.obj_mat_ * warmStartWrenchRatio_;
+  objGrad_ += qpCoeff_.obj_vec_;
+  for(int i = 0; i < varDim; i++)
+  {
+    if((warmStartWrenchRatio_(i) == lowerForce && objGrad_(i) < -thre)
+       || (warmStartWrenchRatio_(i) == upperForce && objGrad_(i) > thre))
+    {
+      return false;
+    }
+  }
+
+  resultWrenchRatio_ = warmStartWrenchRatio_;
+
+  return true;
+}
+
+bool WrenchDistribution::solveActiveSet(bool warmStart)
+{
+  constexpr double thre = 1e-6;
+  const int varDim = static_cast<int>(resultWrenchRatio_.size());
+  const int maxIterNum = 3 * varDim;
+  const double lowerForce = config_.ridgeForceMinMax.first;
+  const double upperForce = config_.ridgeForceMinMax.second;
+  const Eigen::Vector6d weight = config_.wrenchWeight.vector();
+  const Eigen::Vector6d weightSqrt = weight.cwiseSqrt();
+  const Eigen::Vector6d desiredWrench = desiredTotalWrench_.vector();
+
+  // Initialize the feasible point and the active set
+  if(warmStart)
+  {
+    for(int i = 0; i < varDim; i++)
+    {
+      if(resultWrenchRatio_(i) <= lowerForce + thre)
+      {
+        resultWrenchRatio_(i) = lowerForce;
+        boundStateList_(i) = -1;
+      }
+      else if(resultWrenchRatio_(i) >= upperForce - thre)
+      {
+        resultWrenchRatio_(i) = upperForce;
+        boundStateList_(i) = 1;
+      }
+      else
+      {
+        boundStateList_(i) = 0;
+      }
+    }
+  }
+  else
+  {
+    resultWrenchRatio_.setConstant(lowerForce);
+    boundStateList_.setConstant(-1);
+  }
+
+  for(int iter = 0; iter < maxIterNum; iter++)
+  {
+    solveStat_.iterNum = iter + 1;
+
+    // Solve the unconstrained problem of the free variables with the bounded variables fixed
+    Eigen::Matrix6d dualMat = Eigen::Matrix6d::Zero();
+    Eigen::Vector6d fixedWrench = Eigen::Vector6d::Zero();
+    int freeNum = 0;
+    for(int i = 0; i < varDim; i++)
+    {
+      if(boundStateList_(i) == 0)
+      {
+        dualMat.noalias() += totalGraspMat_.col(i) * totalGraspMat_.col(i).transpose();
+        freeNum++;
+      }
+      else
+      {
+        fixedWrench += resultWrenchRatio_(i) * totalGraspMat_.col(i);
+      }
+    }
+    if(freeNum > 0)
+    {
+      dualMat = weightSqrt.asDiagonal() * dualMat * weightSqrt.asDiagonal();
+      dualMat.diagonal().array() += config_.regularWeight;
+      Eigen::LLT<Eigen::Matrix6d> llt(dualMat);
+      if(llt.info() != Eigen::Success)
+      {
+        return false;
+      }
+      Eigen::Vector6d dualVec = weightSqrt.cwiseProduct(
+          llt.solve(static_cast<Eigen::Vector6d>(weightSqrt.cwiseProduct(desiredWrench - fixedWrench))));
+
+      // Move toward the candidate as far as the bounds are satisfied
+      double stepRatio = 1.0;
+      int blockingIdx = -1;
+      for(int i = 0; i < varDim; i++)
+      {
+        if(boundStateList_(i) != 0)
+        {
+          continue;
+        }
+        candidateWrenchRatio_(i) = totalGraspMat_.col(i).dot(dualVec);
+        double bound;
+        if(candidateWrenchRatio_(i) < lowerForce - thre)
+        {
+          bound = lowerForce;
+        }
+        else if(candidateWrenchRatio_(i) > upperForce + thre)
+        {
+          bound = upperForce;
+        }
+        else
+        {
+          continue;
+        }
+        double ratio = (bound - resultWrenchRatio_(i)) / (candidateWrenchRatio_(i) - resultWrenchRatio_(i));
+        if(ratio < stepRatio)
+        {
+          stepRatio = ratio;
+          blockingIdx = i;
+        }
+      }
+
+      for(int i = 0; i < varDim; i++)
+      {
+        if(boundStateList_(i) != 0)
+        {
+          continue;
+        }
+        if(blockingIdx < 0)
+        {
+          resultWrenchRatio_(i) = std::min(std::max(candidateWrenchRatio_(i), lowerForce), upperForce);
+          continue;
+        }
+        resultWrenchRatio_(i) += stepRatio * (candidateWrenchRatio_(i) - resultWrenchRatio_(i));
+        if(i == blockingIdx)
+        {
+          boundStateList_(i) = (candidateWrenchRatio_(i) < lowerForce ? -1 : 1);
+        }
+        else if(resultWrenchRatio_(i) <= lowerForce + thre)
+        {
+          boundStateList_(i) = -1;
+        }
+        else if(resultWrenchRatio_(i) >= upperForce - thre)
+        {
+          boundStateList_(i) = 1;
+        }
+        if(boundStateList_(i) != 0)
+        {
+          resultWrenchRatio_(i) = (boundStateList_(i) < 0 ? lowerForce : upperForce);
+        }
+      }
+
+      // Solve again with the updated active set if the candidate is infeasible
+      if(blockingIdx >= 0)
+      {
+        continue;
+      }
+    }
+
+    // Check the optimality conditions of the bounded variables and release the most violating one
+    Eigen::Vector6d weightedResidual = weight.cwiseProduct(totalGraspMat_ * resultWrenchRatio_ - desiredWrench);
+    double maxViolation = thre;
+    int releaseIdx = -1;
+    for(int i = 0; i < varDim; i++)
+    {
+      if(boundStateList_(i) == 0)
+      {
+        continue;
+      }
+      double grad = totalGraspMat_.col(i).dot(weightedResidual) + config_.regularWeight * resultWrenchRatio_(i);
+      double violation = (boundStateList_(i) < 0 ? -1 * grad : grad);
+      if(violation > maxViolation)
+      {
+        maxViolation = violation;
+        releaseIdx = i;
+      }
+    }
+    if(releaseIdx < 0)
+    {
+      return true;
+    }
+    boundStateList_(releaseIdx) = 0;
+  }
+
+  return false;
+}
+
+FootMap<sva::ForceVecd> WrenchDistribution::calcWrenchList(const Eigen::Vector3d & momentOrigin) const
 {
-  std::unordered_map<Foot, sva::ForceVecd> wrenchList;
+  FootMap<sva::ForceVecd> wrenchList;
   int wrenchRatioIdx = 0;
 
   for(const auto & contactKV : contactList_)